@@ -0,0 +1,103 @@
+#include "black_box.h"
+#include "bsp.h"
+
+static Black_Box box;
+static bool saved = false; // 本次冻结的内容已写入Flash
+
+// 初始化：Flash中有冻结的记录时载入（上电后仍可读出上次的记录），
+// 否则清空并开始记录
+void Black_Box_Init(void) {
+  const Black_Box *stored = (const Black_Box *)BLACK_BOX_FLASH_ADDR;
+  if (stored->magic == BLACK_BOX_MAGIC && stored->count <= BLACK_BOX_SIZE &&
+      stored->trigger != BLACK_BOX_ARMED) {
+    memcpy(&box, stored, sizeof(box));
+    saved = true;
+    printf("Black box: trigger %d, %d records\r\n", box.trigger, box.count);
+    return;
+  }
+  Black_Box_Arm();
+}
+
+// 清空并重新开始记录
+void Black_Box_Arm(void) {
+  memset(&box, 0, sizeof(box));
+  box.magic = BLACK_BOX_MAGIC;
+  saved = false;
+}
+
+bool Black_Box_Frozen(void) {
+  return box.trigger != BLACK_BOX_ARMED && box.post_left == 0;
+}
+
+// 每个控制周期调用一次；冻结后不再写入
+void Black_Box_Record_Cycle(const Black_Box_Record *record) {
+  if (Black_Box_Frozen())
+    return;
+
+  uint16_t tail = (box.head + box.count) & (BLACK_BOX_SIZE - 1);
+  box.records[tail] = *record;
+  if (box.count < BLACK_BOX_SIZE) {
+    box.count++;
+  } else {
+    // 覆盖最早的一条，触发位置随之前移
+    box.head = (box.head + 1) & (BLACK_BOX_SIZE - 1);
+    if (box.trigger_index > 0)
+      box.trigger_index--;
+  }
+
+  if (box.trigger != BLACK_BOX_ARMED)
+    box.post_left--;
+}
+
+// 触发冻结：只响应第一次触发，之后再记录 BLACK_BOX_POST_RECORDS 条
+void Black_Box_Trigger(uint8_t reason) {
+  if (box.trigger != BLACK_BOX_ARMED || box.count == 0)
+    return;
+  box.trigger = reason;
+  box.trigger_tick = HAL_GetTick();
+  box.trigger_index = box.count - 1;
+  box.post_left = BLACK_BOX_POST_RECORDS;
+}
+
+// 已触发时提前结束触发后的记录：离开运行模式后不会再有记录补满，
+// 不冻结的话既写不进Flash，剩下的条数还会记到下一次运行的开头
+void Black_Box_Freeze(void) {
+  if (box.trigger != BLACK_BOX_ARMED)
+    box.post_left = 0;
+}
+
+// 冻结后写入Flash并回读校验（擦除3页期间CPU停顿约60ms，只在停车时调用）
+void Black_Box_Save(void) {
+  if (!Black_Box_Frozen() || saved)
+    return;
+
+  FLASH_EraseInitTypeDef erase = {0};
+  uint32_t page_error = 0;
+  erase.TypeErase = FLASH_TYPEERASE_PAGES;
+  erase.PageAddress = BLACK_BOX_FLASH_ADDR;
+  erase.NbPages = BLACK_BOX_FLASH_PAGES;
+
+  const uint32_t *words = (const uint32_t *)&box;
+  HAL_FLASH_Unlock();
+  HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &page_error);
+  for (uint16_t i = 0; i < sizeof(box) / 4 && status == HAL_OK; i++) {
+    status =
+        HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, BLACK_BOX_FLASH_ADDR + i * 4,
+                          words[i]);
+  }
+  HAL_FLASH_Lock();
+
+  saved = (status == HAL_OK &&
+           memcmp((const void *)BLACK_BOX_FLASH_ADDR, &box, sizeof(box)) == 0);
+  printf("Black box: trigger %d, %d records %s\r\n", box.trigger, box.count,
+         saved ? "saved" : "save failed");
+}
+
+const Black_Box *Black_Box_Get(void) { return &box; }
+
+// 按时间顺序读取第index条（0为最早一条），越界时返回NULL
+const Black_Box_Record *Black_Box_Read(uint16_t index) {
+  if (index >= box.count)
+    return NULL;
+  return &box.records[(box.head + index) & (BLACK_BOX_SIZE - 1)];
+}
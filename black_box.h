@@ -0,0 +1,62 @@
+#ifndef __BLACK_BOX_H
+#define __BLACK_BOX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 黑匣子：运行模式下每个控制周期记录一条定长记录到RAM环形缓冲，
+// 触发（丢线、按键中止、周期超时）后再记录一段即冻结，离开运行模式时提前冻结，
+// 回到选择菜单时写入Flash（掉电保留），经串口调参协议读出
+// 上位机：param_tool <串口> blackbox [文件] 导出CSV，arm 清空并重新开始记录
+
+#define BLACK_BOX_SIZE 256        // 记录条数（2的幂）
+#define BLACK_BOX_POST_RECORDS 64 // 触发后继续记录的条数
+#define BLACK_BOX_OVERRUN_MS 20   // 控制周期超过该值视为故障
+#define BLACK_BOX_MAGIC 0x31584F42u // "BOX1"
+
+// 参数页之前的3页 (6KB)，放得下表头和全部记录
+#define BLACK_BOX_FLASH_ADDR 0x0807E000u
+#define BLACK_BOX_FLASH_PAGES 3
+
+// 冻结原因
+#define BLACK_BOX_ARMED 0   // 记录中，尚未触发
+#define BLACK_BOX_LOST 1    // 巡线丢线后进入倒车或扫描找线
+#define BLACK_BOX_KEY 2     // 运行中按键中止（Key1+Key3）
+#define BLACK_BOX_OVERRUN 3 // 控制周期超时
+
+// 一个控制周期的记录（20字节）
+typedef struct {
+  uint16_t tick;    // 时刻低16位 (ms)
+  uint8_t mode;     // 模式编号
+  uint8_t stage;    // 巡线找线阶段（0为正常巡线）
+  uint8_t median;   // CCD_median
+  uint8_t width;    // 线宽（0为未检出）
+  uint8_t exposure; // 曝光时间
+  uint8_t loop_ms;  // 距上一条记录的时间（饱和到255）
+  int16_t count[2]; // 左右两侧编码器累计值（低16位）
+  int16_t pwm[4];   // 四路电机命令
+} Black_Box_Record;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t trigger_tick;  // 触发时刻 (ms)
+  uint16_t count;         // 有效记录数
+  uint16_t head;          // 最早一条记录在缓冲中的位置
+  uint16_t trigger_index; // 触发时的记录（相对最早一条的序号）
+  uint8_t trigger;        // 冻结原因（BLACK_BOX_ARMED为未触发）
+  uint8_t post_left;      // 触发后还要记录的条数
+  Black_Box_Record records[BLACK_BOX_SIZE];
+} Black_Box;
+
+// 函数声明
+void Black_Box_Init(void);
+void Black_Box_Arm(void);
+void Black_Box_Record_Cycle(const Black_Box_Record *record);
+void Black_Box_Trigger(uint8_t reason);
+void Black_Box_Freeze(void);
+bool Black_Box_Frozen(void);
+void Black_Box_Save(void);
+const Black_Box *Black_Box_Get(void);
+const Black_Box_Record *Black_Box_Read(uint16_t index);
+
+#endif
@@ -1,72 +1,82 @@
 #include "bsp.h"
+#include "black_box.h"
+#include "mode_manager.h"
+#include "param_link.h"
+#include "vision_link.h"
 
-static RunMode current_mode = MODE_STOP;
+// 巡线模式
+static void Track_Mode_Init(void) {
+  Track_Reset(); // 重置巡线状态
+  OLED_Draw_Line("Tracking Mode", 0, true, true);
+}
+
+static void Track_Mode_Step(void) {
+  // 左右两侧编码器均值作为里程计输入（丢线后按记录的线位置找线）
+  const int32_t *count = sensor_data.encoder;
+  Track_Update_Odometry((count[MOTOR_ID_M1] + count[MOTOR_ID_M2]) / 2,
+                        (count[MOTOR_ID_M3] + count[MOTOR_ID_M4]) / 2);
+  Track_Update();                       // 更新巡线控制
+  OLED_Show_CCD_Image(CCD_Get_Frame()); // 实时更新显示
+
+  if (Track_Searching())
+    Black_Box_Trigger(BLACK_BOX_LOST);
+}
+
+const Mode_Desc Mode_Track = {"Track", SENSOR_CCD | SENSOR_ENCODER,
+                              Track_Mode_Init, Track_Mode_Step, Track_Stop};
+
+// CCD显示模式
+static void CCD_View_Init(void) {
+  OLED_Draw_Line("Display Mode", 0, true, true);
+}
+
+static void CCD_View_Step(void) {
+  Print_CCD_data(); // 显示详细数据并更新OLED
+}
+
+const Mode_Desc Mode_CCD_View = {"CCD View",    SENSOR_CCD,
+                                 CCD_View_Init, CCD_View_Step,
+                                 NULL,          MODE_DISPLAY_PERIOD_MS};
+
+// 视觉协处理器：USART2 DMA循环接收（CubeMX中DMA模式设为Circular），
+// 空闲、半满、全满时在中断中解析新到的字节
+static void Vision_Rx_Start(void) {
+  HAL_UARTEx_ReceiveToIdle_DMA(&huart2, Vision_Link_Rx_Buffer(),
+                               VISION_LINK_RX_SIZE);
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size) {
+  if (huart == &huart2)
+    Vision_Link_Rx_Update(size, HAL_GetTick());
+}
 
 // Hardware Initialization
 void BSP_Init(void) {
-  USART1_UART_Init();
+  Delay_Init();
+  Bsp_UART1_Init();
   OLED_Init();
   OLED_Clear();
   OLED_Draw_Line("System Ready!", 0, true, true);
-  OLED_Draw_Line("Key1:Track Key2:Display", 2, true, true);
   Bsp_Tim_Init();
-  Track_Init(); // 初始化巡线控制
-}
-
-// 更新运行模式
-static void Update_Mode(void) {
-  if (Key1_State(1)) { // Key1按下切换巡线/停止
-    if (current_mode != MODE_TRACKING) {
-      current_mode = MODE_TRACKING;
-      Track_Reset(); // 重置巡线状态
-      OLED_Clear();
-      OLED_Draw_Line("Tracking Mode", 0, true, true);
-      printf("\r\nEntering Tracking Mode\r\n");
-    } else {
-      current_mode = MODE_STOP;
-      Track_Stop();
-      OLED_Clear();
-      OLED_Draw_Line("Stop Mode", 0, true, true);
-      printf("\r\nStopped\r\n");
-    }
-  }
-
-  if (Key2_State(1)) { // Key2按下切换显示/停止
-    if (current_mode != MODE_DISPLAY) {
-      current_mode = MODE_DISPLAY;
-      Track_Stop();
-      OLED_Clear();
-      OLED_Draw_Line("Display Mode", 0, true, true);
-      printf("\r\nEntering Display Mode\r\n");
-    } else {
-      current_mode = MODE_STOP;
-      OLED_Clear();
-      OLED_Draw_Line("Stop Mode", 0, true, true);
-      printf("\r\nStopped\r\n");
-    }
-  }
+  Bsp_TIM7_Init();
+  Motor_Output_Init();
+  Param_Link_Init();   // 加载保存的参数，启动串口调参
+  Vision_Link_Init();  // 视觉协处理器链路
+  Vision_Rx_Start();   // 开始DMA接收
+  Black_Box_Init();    // 载入上次冻结的记录或开始记录
+  Track_Init();        // 初始化巡线控制
+  Mode_Manager_Init(); // 进入模式选择菜单
 }
 
 // Loop Run Function
 void BSP_Loop(void) {
-  Update_Mode(); // 更新运行模式
-
-  switch (current_mode) {
-  case MODE_TRACKING:
-    Track_Update();                            // 更新巡线控制
-    OLED_Show_CCD_Image(CCD_Get_ADC_128X32()); // 实时更新显示
-    break;
-
-  case MODE_DISPLAY:
-    Print_CCD_data(); // 显示详细数据并更新OLED
-    break;
+  Mode_Manager_Step(); // 处理模式切换并执行当前模式
 
-  case MODE_STOP:
-  default:
-    Motor_Stop(1);                             // 确保电机停止
-    OLED_Show_CCD_Image(CCD_Get_ADC_128X32()); // 保持显示更新
-    break;
+  // 串口出错（溢出、帧错误）时HAL会停止DMA接收，从缓冲开头重新开始
+  if (huart2.RxState == HAL_UART_STATE_READY) {
+    Vision_Link_Rx_Restart();
+    Vision_Rx_Start();
   }
 
-  HAL_Delay(1); // 最小延时，保证系统稳定
+  Mode_Manager_Wait(); // 全速模式延时1ms，低功耗模式休眠到下一周期
 }
@@ -2,6 +2,7 @@
 #define __BSP_CCD_H_
 
 #include "bsp.h"
+#include "ccd_telemetry.h"
 
 // IO口操作宏定义
 #define BITBAND(addr, bitnum)                                                  \
@@ -23,6 +24,9 @@
 #define MIN_LINE_WIDTH 4
 #define MAX_LINE_WIDTH 30
 #define NOISE_THRESHOLD 5
+#define CCD_EDGE_GATE_DIV 5       // 边缘导数门限 = 黑白两类均值之差 / 该值
+#define CCD_EDGE_GATE_WHITE_DIV 7 // 门限不低于白电平 / 该值（挡住浅色污渍）
+#define CCD_EDGE_GATE_MIN 3       // 门限下限（高于平滑后的噪声）
 #define SIGNAL_SMOOTH_SIZE 3
 #define MAX_EDGE_PAIRS 5
 
@@ -32,7 +36,40 @@
 #define TARGET_MAX_VALUE 140
 #define TARGET_MIN_VALUE 40
 
+// 阈值参数（采样为8位）
+#define CCD_HIST_SHIFT 3                      // 直方图每格8个灰度
+#define CCD_HIST_BINS (256 >> CCD_HIST_SHIFT) // 32格
+#define CCD_BLOCK_SIZE 16                     // 局部阈值的分块宽度
+#define CCD_BLOCKS (128 / CCD_BLOCK_SIZE)
+#define THRESHOLD_MODE_DEFAULT THRESHOLD_OTSU
+#define LOCAL_BLEND_DEFAULT 50 // 局部阈值所占比例 (%)
+
+// 全局阈值算法
+#define THRESHOLD_OTSU 0   // 类间方差最大的分割，阈值取两类均值的中点
+#define THRESHOLD_VALLEY 1 // Otsu两类峰值之间的直方图谷底
+
+// 时域滤波参数（逐像素IIR，见 Temporal_Filter）
+#define TEMPORAL_WEIGHT_DEFAULT 0 // 静止像素中新帧的权重 (1/16)，0为关闭
+#define TEMPORAL_NOISE 8          // 与滤波值相差不超过该值视为噪声
+#define TEMPORAL_MOTION 32        // 相差达到该值视为运动，直接取新值
+
+// 过采样读出：每个像素用短采样时间连续转换多次取平均，均值保留12位精度
+// （存入 CCD_Process.fine）。按ADC时钟12MHz估算（未在实车上测量）：
+// 单次长采样 239.5+12.5 周期约21us，短采样 28.5+12.5 周期约3.4us，
+// 6次约20.5us，与单次相当，白噪声降到约1/2.4；再多读出就比原来慢，故取6为上限
+#define CCD_OVERSAMPLE_DEFAULT 1  // 每像素采样次数，1为原来的单次长采样
+#define CCD_OVERSAMPLE_MAX 6      // 采样次数上限（读出时间不超过单次长采样）
+#define CCD_OVERSAMPLE_SAMPLETIME ADC_SAMPLETIME_28CYCLES_5
+#define CCD_ADC_TIMEOUT_US 100    // 单次转换等待EOC的上限
+
+// 遥测参数
+#define CCD_STREAM_DEFAULT 0 // 上电时是否发送遥测（可经串口"tel.on"打开）
+
 // 数据处理结构体
+// 每帧只保存一份8位采样（12位ADC右移4位），显示和日志直接引用，不再复制
+// 默认的单次采样、不做时域滤波时只用这一份，平滑原地进行；
+// 过采样或时域滤波时另用一份12位缓冲（8.4定点），两者共用：
+// 滤波打开时它就是跨帧保留的滤波状态，新采样逐点并入，不另存本帧
 typedef struct {
   uint16_t max_value;
   uint16_t min_value;
@@ -42,9 +79,13 @@ typedef struct {
   uint8_t line_width;
   uint8_t exposure_time;
   uint8_t stable_count;
-  uint16_t raw_data[128];
-  uint16_t smooth_data[128];
-  bool is_black[128];
+  uint8_t raw_data[128];     // 本帧采样，滤波、平滑后原地覆盖
+  uint16_t fine[128];        // 12位缓冲：滤波状态，或过采样时本帧的ADC均值
+  uint8_t fine_valid;        // 本帧的12位采样已在fine中，否则平滑用8位采样
+  uint16_t read_us;          // 最近一次读出整帧的耗时 (us)
+  uint16_t adc_timeouts;     // ADC转换超时的帧数（累计）
+  uint8_t temporal_exposure; // 滤波状态对应的曝光时间，0为未初始化
+  uint32_t black_mask[4];    // 低于阈值的像素（按位，第i位对应第i个像素）
   struct {
     uint8_t left;
     uint8_t right;
@@ -54,18 +95,37 @@ typedef struct {
   uint8_t edge_count;
 } CCD_Process;
 
+// 运行时可调参数（默认值取上面的宏，可经串口修改，见 param_table.c）
+typedef struct {
+  uint16_t target_max; // 曝光控制目标上限
+  uint16_t target_min; // 曝光控制目标下限
+  uint8_t min_exposure;
+  uint8_t max_exposure;
+  uint8_t stream;            // 非0时每帧发送压缩遥测（见 CCD_Stream_Frame）
+  uint8_t keyframe_interval; // 遥测关键帧间隔（帧）
+  uint8_t threshold_mode;    // THRESHOLD_OTSU / THRESHOLD_VALLEY
+  uint8_t local_blend;       // 局部阈值所占比例 (%)，0为纯全局阈值
+  uint8_t temporal_weight;   // 时域滤波新帧权重 (1/16)，0或16为关闭
+  uint8_t oversample;        // 每像素采样次数，1为单次长采样
+} CCD_Config;
+
+// 第i个像素是否判为黑线（由Find_CCD_Median更新）
+#define CCD_IS_BLACK(i) ((ccd.black_mask[(i) >> 5] >> ((i) & 31)) & 1u)
+
 // 全局变量声明
-extern uint16_t ADV[128];
 extern uint8_t CCD_median;
 extern uint8_t CCD_threshold;
-extern uint8_t ADC_128X32[128];
 extern CCD_Process ccd;
+extern CCD_Config ccd_config;
 
 // 函数声明
+void RD_TSL(void);
 void Deal_Data_CCD(void);
+void CCD_Store_Fine(uint8_t index, uint16_t sample);
 void Find_CCD_Median(void);
 void Print_CCD_data(void);
-uint8_t *CCD_Get_ADC_128X32(void);
-void OLED_Show_CCD_Image(uint8_t *p_img);
+void CCD_Stream_Frame(void);
+const uint8_t *CCD_Get_Frame(void);
+void OLED_Show_CCD_Image(const uint8_t *frame);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include "bsp_ccd.h"
+
+// CCD数据处理：平滑、中线检测和曝光控制，不直接访问硬件，
+// 数据由RD_TSL提供（板上由bsp_ccd.c采集，主机仿真中由仿真程序合成）
+
+// 全局变量定义
+uint8_t CCD_median = 64;     // 初始化为中间位置
+uint8_t CCD_threshold = 128; // 初始化为中间值
+CCD_Process ccd = {.exposure_time = 10, .stable_count = 0};
+CCD_Config ccd_config = {TARGET_MAX_VALUE,       TARGET_MIN_VALUE,
+                         MIN_EXPOSURE_TIME,      MAX_EXPOSURE_TIME,
+                         CCD_STREAM_DEFAULT,     CCD_TLM_KEYFRAME_INTERVAL,
+                         THRESHOLD_MODE_DEFAULT, LOCAL_BLEND_DEFAULT,
+                         TEMPORAL_WEIGHT_DEFAULT, CCD_OVERSAMPLE_DEFAULT};
+
+// 快速聚类分析结构体
+typedef struct {
+  uint32_t sum;   // 数值和
+  uint16_t count; // 点数
+  uint16_t mean;  // 均值
+} Cluster;
+
+// 平滑时顺带统计的直方图和分块白电平，阈值计算不再单独遍历采样
+typedef struct {
+  uint8_t count[CCD_HIST_BINS];
+  uint16_t sum[CCD_HIST_BINS];     // 每格内采样值之和，用于求精确的类均值
+  uint8_t block_white[CCD_BLOCKS]; // 每块的最大值
+} Histogram;
+
+static Histogram hist;
+static uint8_t block_threshold[CCD_BLOCKS]; // 每块中心处的阈值
+
+static uint8_t temporal_weight = 0; // 本帧的时域滤波权重，0为不滤波
+static bool temporal_reset = false; // 本帧用新采样重新初始化滤波状态
+
+// 读出前确定本帧是否做时域滤波（ccd.tf为0或16时不滤波）
+// 首帧或曝光时间变化后整帧灰度跳变，用本帧重新初始化
+static void Temporal_Begin(void) {
+  uint8_t weight = ccd_config.temporal_weight;
+  if (weight == 0 || weight >= 16) {
+    temporal_weight = 0;
+    ccd.temporal_exposure = 0;
+    return;
+  }
+  temporal_weight = weight;
+  temporal_reset = (ccd.temporal_exposure != ccd.exposure_time);
+  ccd.temporal_exposure = ccd.exposure_time;
+}
+
+// 存入一个像素的12位采样（8.4定点）：过采样读出时由RD_TSL逐点调用
+// 时域滤波时fine就是滤波状态，采样直接并入：每个像素一阶IIR，
+// 新帧权重按该像素与滤波值之差自适应：噪声范围内用小权重压住帧间抖动，
+// 差值超过运动门限（边缘移动、横线进入）时直接取新值，边缘不拖尾也不变缓
+void CCD_Store_Fine(uint8_t index, uint16_t sample) {
+  if (temporal_weight == 0 || temporal_reset) {
+    ccd.fine[index] = sample;
+    return;
+  }
+
+  const uint16_t noise = TEMPORAL_NOISE << 4;
+  const uint16_t ramp = (TEMPORAL_MOTION - TEMPORAL_NOISE) << 4;
+  int16_t diff = sample - ccd.fine[index];
+  uint16_t magnitude = ABS(diff);
+  uint8_t w = temporal_weight;
+  if (magnitude >= noise + ramp)
+    w = 16;
+  else if (magnitude > noise)
+    w += (16 - temporal_weight) * (magnitude - noise) / ramp;
+
+  ccd.fine[index] += diff * w / 16; // 保留滤波值的小数部分供平滑使用
+}
+
+// 单次采样时对8位采样做时域滤波（过采样时读出中已经做过）
+static void Temporal_Filter(void) {
+  if (temporal_weight == 0 || ccd.fine_valid)
+    return;
+  for (int i = 0; i < 128; i++) {
+    CCD_Store_Fine(i, ccd.raw_data[i] << 4);
+  }
+  ccd.fine_valid = 1;
+}
+
+// 平滑的输入：12位缓冲有效时取12位采样，否则由8位采样扩展
+static uint16_t Fine_Sample(int i) {
+  return ccd.fine_valid ? ccd.fine[i] : ccd.raw_data[i] << 4;
+}
+
+// 数据平滑处理：对12位采样加权平均，结果原地写回8位采样
+// 过采样和时域滤波时平滑结果不受8位量化的影响
+static void Smooth_Data(void) {
+  // 5点加权移动平均，中心点权重最大
+  const uint8_t weights[5] = {1, 2, 3, 2, 1};
+  uint16_t window[5] = {0}; // 第i-2到i+2点的原值，左侧两点在原地写回前取出
+
+  memset(&hist, 0, sizeof(hist));
+  window[3] = Fine_Sample(0);
+  window[4] = Fine_Sample(1);
+
+  for (int i = 0; i < 128; i++) {
+    uint16_t sum = 0;
+    uint8_t weight_sum = 0;
+
+    window[0] = window[1];
+    window[1] = window[2];
+    window[2] = window[3];
+    window[3] = window[4];
+    if (i + 2 < 128)
+      window[4] = Fine_Sample(i + 2);
+
+    // 对每个点进行加权平均，两端只用范围内的点
+    if (i >= 2 && i < 126) {
+      sum = window[0] + 2 * (window[1] + window[3]) + 3 * window[2] + window[4];
+      weight_sum = 9;
+    } else {
+      for (int j = -2; j <= 2; j++) {
+        if (i + j >= 0 && i + j < 128) {
+          sum += window[j + 2] * weights[j + 2];
+          weight_sum += weights[j + 2];
+        }
+      }
+    }
+
+    // 保存平滑后的数据
+    uint8_t value = (sum / weight_sum) >> 4;
+    ccd.raw_data[i] = value;
+
+    hist.count[value >> CCD_HIST_SHIFT]++;
+    hist.sum[value >> CCD_HIST_SHIFT] += value;
+    if (value > hist.block_white[i / CCD_BLOCK_SIZE])
+      hist.block_white[i / CCD_BLOCK_SIZE] = value;
+  }
+}
+
+// Otsu分割：按类间方差 (s0*w1 - s1*w0)^2 / (w0*w1) 最大选取分割位置，
+// 只用逐格累加的点数和数值和；|差|最大约255*64*64，右移4位后平方仍在32位内
+static uint8_t Otsu_Split(Cluster *low, Cluster *high) {
+  uint32_t total_sum = 0;
+  for (uint8_t b = 0; b < CCD_HIST_BINS; b++) {
+    total_sum += hist.sum[b];
+  }
+
+  uint32_t best_score = 0;
+  uint8_t split = 0;
+  uint16_t w0 = 0;
+  uint32_t s0 = 0;
+  *low = (Cluster){0, 0, 0};
+  for (uint8_t b = 0; b + 1 < CCD_HIST_BINS; b++) {
+    w0 += hist.count[b];
+    s0 += hist.sum[b];
+    if (w0 == 0 || w0 == 128)
+      continue;
+
+    uint16_t w1 = 128 - w0;
+    int32_t d = (int32_t)(s0 * w1) - (int32_t)((total_sum - s0) * w0);
+    uint32_t q = (uint32_t)ABS(d) >> 4;
+    uint32_t score = q * q / ((uint32_t)w0 * w1);
+    if (score > best_score) {
+      best_score = score;
+      split = b + 1;
+      *low = (Cluster){s0, w0, 0};
+    }
+  }
+
+  // 没有可分的两类（整帧同一灰度）时全部归入高类
+  high->sum = total_sum - low->sum;
+  high->count = 128 - low->count;
+  low->mean = low->count ? low->sum / low->count : 0;
+  high->mean = high->sum / high->count;
+  if (low->count == 0)
+    low->mean = high->mean;
+  return split;
+}
+
+// 谷底阈值：两类各自峰值之间计数最少的格（相邻三格求和抑制噪声），
+// 峰值靠得太近没有谷底时返回fallback
+static uint8_t Valley_Threshold(uint8_t split, uint8_t fallback) {
+  uint8_t p0 = 0, p1 = split;
+  for (uint8_t b = 0; b < CCD_HIST_BINS; b++) {
+    if (b < split && hist.count[b] > hist.count[p0])
+      p0 = b;
+    if (b >= split && hist.count[b] > hist.count[p1])
+      p1 = b;
+  }
+  if (p1 < p0 + 2)
+    return fallback;
+
+  uint8_t valley = p0 + 1;
+  uint16_t lowest = 0xFFFF;
+  for (uint8_t b = p0 + 1; b < p1; b++) {
+    uint16_t depth = hist.count[b - 1] + hist.count[b] + hist.count[b + 1];
+    if (depth < lowest) {
+      lowest = depth;
+      valley = b;
+    }
+  }
+  return (valley << CCD_HIST_SHIFT) + (1 << (CCD_HIST_SHIFT - 1));
+}
+
+// 分块阈值：局部阈值取该块白电平与全局黑电平的中点，再与全局阈值按比例混合
+// 整块都低于全局阈值（被黑线或横线盖住）时该块按全局白电平计算
+static void Update_Block_Threshold(uint8_t threshold, const Cluster *low,
+                                   const Cluster *high) {
+  uint8_t blend = ccd_config.local_blend;
+  if (blend > 100)
+    blend = 100;
+  for (uint8_t k = 0; k < CCD_BLOCKS; k++) {
+    uint16_t white = hist.block_white[k];
+    if (white < threshold)
+      white = high->mean;
+    uint16_t local = low->mean + (white - low->mean) / 2;
+    block_threshold[k] = (threshold * (100 - blend) + local * blend) / 100;
+  }
+}
+
+// 一阶差分（边缘检测），按需计算不单独存数组
+static int16_t Derivative(int i) {
+  return ccd.raw_data[i + 1] - ccd.raw_data[i];
+}
+
+// 更新曝光时间
+static void Update_Exposure_Time(void) {
+  if (ccd.max_value > ccd_config.target_max) {
+    if (ccd.exposure_time > ccd_config.min_exposure) {
+      ccd.exposure_time--;
+      ccd.stable_count = 0;
+    }
+  } else if (ccd.max_value < ccd_config.target_min) {
+    if (ccd.exposure_time < ccd_config.max_exposure) {
+      ccd.exposure_time++;
+      ccd.stable_count = 0;
+    }
+  } else if (ccd.stable_count < 255) {
+    ccd.stable_count++;
+  }
+}
+
+// 查找CCD中线（使用Smooth_Data在同一帧统计的直方图）
+void Find_CCD_Median(void) {
+  // 1. 由平滑时统计的直方图计算全局阈值（Otsu或谷底）
+  Cluster low_cluster, high_cluster;
+  uint8_t split = Otsu_Split(&low_cluster, &high_cluster);
+
+  uint8_t threshold = (low_cluster.mean + high_cluster.mean) / 2;
+  if (ccd_config.threshold_mode == THRESHOLD_VALLEY)
+    threshold = Valley_Threshold(split, threshold);
+  CCD_threshold = threshold;
+
+  // 2. 按分块白电平混合局部阈值，补偿渐晕和不均匀光照
+  Update_Block_Threshold(threshold, &low_cluster, &high_cluster);
+
+  // 3. 边缘检测和黑线定位
+  int8_t start_pos = -1;
+  uint8_t current_width = 0;
+  int8_t best_start = -1;
+  uint8_t best_width = 0;
+  int16_t best_quality = INT16_MIN;
+
+  // 边缘导数门限随两类均值之差缩放：5点平滑后阶跃的最大一阶差分
+  // 约为阶跃高度的1/3，弱光下反差小时固定门限会漏掉真实边缘
+  int16_t edge_gate =
+      (high_cluster.mean - low_cluster.mean) / CCD_EDGE_GATE_DIV;
+  if (edge_gate < high_cluster.mean / CCD_EDGE_GATE_WHITE_DIV)
+    edge_gate = high_cluster.mean / CCD_EDGE_GATE_WHITE_DIV;
+  if (edge_gate < CCD_EDGE_GATE_MIN)
+    edge_gate = CCD_EDGE_GATE_MIN;
+
+  // 阈值在相邻块中心之间线性插值（两端保持端块的值），
+  // 用1/16定点逐像素累加斜率，块宽为16时恰好没有误差
+  int16_t pixel_threshold = block_threshold[0] << 4;
+  int16_t slope = 0;
+
+  // 单遍扫描查找最佳黑线段，同时记录黑白掩码
+  memset(ccd.black_mask, 0, sizeof(ccd.black_mask));
+  for (int i = 0; i < 128; i++) {
+    if (i % CCD_BLOCK_SIZE == CCD_BLOCK_SIZE / 2) {
+      uint8_t k = i / CCD_BLOCK_SIZE;
+      slope = (k + 1 < CCD_BLOCKS)
+                  ? (block_threshold[k + 1] - block_threshold[k]) * 16 /
+                        CCD_BLOCK_SIZE
+                  : 0;
+    }
+    uint8_t black = ccd.raw_data[i] < (pixel_threshold >> 4);
+    pixel_threshold += slope;
+
+    if (black) {
+      ccd.black_mask[i >> 5] |= 1u << (i & 31);
+      if (current_width == 0) {
+        // 检查左边缘的梯度：平滑后边缘变缓，阈值交点两侧的导数满足其一即可
+        if (i > 0 && (Derivative(i - 1) < -edge_gate ||
+                      (i < 127 && Derivative(i) < -edge_gate))) { // 下降边缘
+          start_pos = i;
+        }
+      }
+      current_width++;
+    } else {
+      if (current_width > 0) {
+        // 检查右边缘的梯度（与左边缘对称，取阈值交点两侧的上升沿）
+        if (start_pos != -1 &&
+            (Derivative(i - 1) > edge_gate ||
+             (i > 1 && Derivative(i - 2) > edge_gate))) { // 上升边缘
+          // 找到一段黑线，检查是否是最佳的
+          if (current_width > 3 && current_width < 40) {
+            // 计算这段区域的均值和方差
+            uint32_t segment_sum = 0;
+            uint32_t segment_sq_sum = 0;
+            for (int j = start_pos; j < start_pos + current_width; j++) {
+              segment_sum += ccd.raw_data[j];
+              segment_sq_sum += ccd.raw_data[j] * ccd.raw_data[j];
+            }
+            uint16_t segment_mean = segment_sum / current_width;
+            uint32_t variance =
+                segment_sq_sum / current_width - segment_mean * segment_mean;
+
+            // 计算质量分数：考虑方差、与白电平的反差、边缘强度和位置
+            uint16_t mean_diff = ABS(high_cluster.mean - segment_mean);
+            uint16_t edge_strength =
+                ABS(Derivative(start_pos - 1)) +
+                ABS(Derivative(start_pos + current_width - 1));
+            uint16_t center_dist = ABS(start_pos + current_width / 2 - 64);
+            // 有符号计算后限幅，负分不会回绕成很大的正数
+            int32_t score = (mean_diff * 2) + (edge_strength / 2) -
+                            (int32_t)(variance / 100) - (center_dist * 2);
+            int16_t quality = (score < INT16_MIN)   ? INT16_MIN
+                              : (score > INT16_MAX) ? INT16_MAX
+                                                    : score;
+
+            if (variance < 1000 && quality > best_quality) {
+              best_start = start_pos;
+              best_width = current_width;
+              best_quality = quality;
+            }
+          }
+        }
+        start_pos = -1;
+        current_width = 0;
+      }
+    }
+  }
+
+  // 4. 更新结果
+  if (best_start != -1) {
+    ccd.left_edge = best_start;
+    ccd.right_edge = best_start + best_width;
+    ccd.line_width = best_width;
+    CCD_median = best_start + best_width / 2;
+  } else {
+    ccd.line_width = 0; // 标记丢线
+  }
+
+  // 亮度统计每帧都更新，丢线时曝光控制也不会失去依据
+  ccd.max_value = high_cluster.mean;
+  ccd.min_value = low_cluster.mean;
+}
+
+// 处理CCD数据
+void Deal_Data_CCD(void) {
+  ccd.fine_valid = 0;     // 过采样读出时由RD_TSL置位
+  Temporal_Begin();       // 确定本帧是否时域滤波
+  RD_TSL();               // 采集数据，过采样时逐点存入12位缓冲
+  Temporal_Filter();      // 单次采样时的时域滤波（ccd.tf为0时跳过）
+  Smooth_Data();          // 平滑处理
+  Find_CCD_Median();      // 使用平滑后的数据进行中线检测
+  Update_Exposure_Time(); // 更新曝光时间
+}
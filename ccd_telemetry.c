@@ -0,0 +1,385 @@
+#include "ccd_telemetry.h"
+#include <string.h>
+
+// 解码器组包状态
+enum {
+  TLM_WAIT_SYNC0 = 0,
+  TLM_WAIT_SYNC1,
+  TLM_WAIT_LEN,
+  TLM_PAYLOAD,
+  TLM_WAIT_CRC,
+};
+
+// CRC-8（多项式0x07），可分段累加
+static uint8_t Crc8(uint8_t crc, const uint8_t *data, uint16_t len) {
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// 差值类别：0为零，1为-1..1，2为-8..7，3为其它
+static uint8_t Delta_Class(int16_t delta) {
+  if (delta == 0)
+    return 0;
+  if (delta >= -1 && delta <= 1)
+    return 1;
+  if (delta >= -8 && delta <= 7)
+    return 2;
+  return 3;
+}
+
+static bool Mask_Bit(const uint32_t *mask, uint8_t i) {
+  return (mask[i >> 5] >> (i & 31)) & 1u;
+}
+
+// ---------------------------------------------------------------------------
+// 编码
+
+void CCD_Tlm_Encoder_Init(CCD_Tlm_Encoder *enc, uint8_t keyframe_interval) {
+  memset(enc->reference, 0, sizeof(enc->reference));
+  enc->seq = 0;
+  enc->skipped = 0;
+  enc->since_key = 0;
+  enc->keyframe_interval = keyframe_interval;
+  enc->need_key = true;
+}
+
+// 下一帧强制发送关键帧（上一包未能发出时调用）
+void CCD_Tlm_Request_Keyframe(CCD_Tlm_Encoder *enc) { enc->need_key = true; }
+
+// 本帧不发送（串口忙）：只计数，参考帧不变，下一包的差值仍可重建
+void CCD_Tlm_Skip_Frame(CCD_Tlm_Encoder *enc) {
+  if (enc->skipped < 255)
+    enc->skipped++;
+}
+
+// 掩码游程编码，游程过多时写原始位图；返回写入字节数
+static uint8_t Encode_Mask(const uint32_t *mask, uint8_t *out) {
+  uint8_t runs = 0, length = 0;
+  bool color = false; // 从白色开始
+
+  for (uint8_t i = 0; i < 128; i++) {
+    if (Mask_Bit(mask, i) != color) {
+      if (runs == CCD_TLM_MAX_MASK_RUNS)
+        break;
+      out[1 + runs++] = length;
+      length = 0;
+      color = !color;
+    }
+    length++;
+  }
+
+  if (runs < CCD_TLM_MAX_MASK_RUNS) {
+    out[1 + runs++] = length;
+    out[0] = runs;
+    return 1 + runs;
+  }
+
+  // 游程太多（噪声帧）：原始位图，小端
+  out[0] = 0;
+  for (uint8_t w = 0; w < 4; w++) {
+    for (uint8_t b = 0; b < 4; b++) {
+      out[1 + w * 4 + b] = (uint8_t)(mask[w] >> (8 * b));
+    }
+  }
+  return 17;
+}
+
+// 从i开始的零差值个数（最多max个）
+static uint8_t Zero_Run(const uint8_t *samples, const uint8_t *reference,
+                        uint8_t i, uint8_t max) {
+  uint8_t run = 0;
+  while (i + run < 128 && run < max && samples[i + run] == reference[i + run])
+    run++;
+  return run;
+}
+
+// 差值记号编码；超过limit字节时放弃并返回0
+// 平滑后的帧间差值大多在-1..1内（2位），只在线边缘移动处出现较大的差值
+static uint8_t Encode_Delta(const uint8_t *samples, const uint8_t *reference,
+                            uint8_t *out, uint8_t limit) {
+  uint8_t n = 0;
+  uint8_t i = 0;
+
+  while (i < 128) {
+    uint8_t run = Zero_Run(samples, reference, i, CCD_TLM_TOKEN_MAX_RUN);
+    uint8_t cls = Delta_Class(samples[i] - reference[i]);
+    uint8_t token, bits;
+
+    if (run >= CCD_TLM_ZERO_RUN_MIN || i + run == 128) {
+      token = CCD_TLM_TOKEN_ZERO;
+      bits = 0;
+    } else if (cls <= 1) {
+      // 小差值，遇到足够长的零游程时结束
+      run = 0;
+      while (i + run < 128 && run < CCD_TLM_TOKEN_MAX_RUN &&
+             Delta_Class(samples[i + run] - reference[i + run]) <= 1 &&
+             Zero_Run(samples, reference, i + run, CCD_TLM_ZERO_RUN_MIN) <
+                 CCD_TLM_ZERO_RUN_MIN)
+        run++;
+      token = CCD_TLM_TOKEN_SMALL;
+      bits = 2;
+    } else {
+      // 中等差值用4位，其余直接发送原值
+      run = 0;
+      while (i + run < 128 && run < CCD_TLM_TOKEN_MAX_RUN &&
+             Delta_Class(samples[i + run] - reference[i + run]) == cls)
+        run++;
+      token = (cls == 2) ? CCD_TLM_TOKEN_NIBBLE : CCD_TLM_TOKEN_LITERAL;
+      bits = (cls == 2) ? 4 : 8;
+    }
+
+    uint8_t bytes = (run * bits + 7) / 8;
+    if (n + 1 + bytes > limit)
+      return 0;
+    out[n++] = token | (run - 1);
+    if (bits == 8) {
+      memcpy(&out[n], &samples[i], run);
+    } else if (bits > 0) {
+      memset(&out[n], 0, bytes);
+      uint8_t field = (1 << bits) - 1;
+      for (uint8_t k = 0; k < run; k++) {
+        uint8_t code = (uint8_t)(samples[i + k] - reference[i + k]) & field;
+        out[n + k * bits / 8] |= code << ((k * bits) & 7);
+      }
+    }
+    n += bytes;
+    i += run;
+  }
+  return n;
+}
+
+// 编码一帧为完整的包，返回包长度；packet至少CCD_TLM_MAX_PACKET字节
+// 到达关键帧间隔、请求过关键帧或差值编码不比原始数据短时发送关键帧
+uint16_t CCD_Tlm_Encode(CCD_Tlm_Encoder *enc, const uint8_t *samples,
+                        const uint32_t *mask, const CCD_Tlm_Overlay *overlay,
+                        uint8_t *packet) {
+  uint8_t *payload = &packet[3];
+  uint8_t n = CCD_TLM_HEADER_SIZE;
+
+  payload[1] = enc->seq++;
+  payload[2] = enc->skipped;
+  payload[3] = (uint8_t)overlay->tick;
+  payload[4] = (uint8_t)(overlay->tick >> 8);
+  payload[5] = overlay->median;
+  payload[6] = overlay->left_edge;
+  payload[7] = overlay->right_edge;
+  payload[8] = overlay->line_width;
+  payload[9] = overlay->threshold;
+  payload[10] = overlay->exposure;
+  enc->skipped = 0;
+  n += Encode_Mask(mask, &payload[n]);
+
+  uint8_t delta_len = 0;
+  if (!enc->need_key && enc->since_key + 1 < enc->keyframe_interval)
+    delta_len = Encode_Delta(samples, enc->reference, &payload[n], 127);
+
+  if (delta_len > 0) {
+    payload[0] = CCD_TLM_DELTA;
+    n += delta_len;
+    enc->since_key++;
+  } else {
+    payload[0] = CCD_TLM_KEYFRAME;
+    memcpy(&payload[n], samples, 128);
+    n += 128;
+    enc->since_key = 0;
+    enc->need_key = false;
+  }
+  memcpy(enc->reference, samples, 128);
+
+  packet[0] = CCD_TLM_SYNC0;
+  packet[1] = CCD_TLM_SYNC1;
+  packet[2] = n;
+  packet[3 + n] = Crc8(0, &packet[2], n + 1);
+  return n + 4;
+}
+
+// ---------------------------------------------------------------------------
+// 解码
+
+void CCD_Tlm_Decoder_Init(CCD_Tlm_Decoder *dec) {
+  memset(dec, 0, sizeof(*dec));
+  dec->state = TLM_WAIT_SYNC0;
+}
+
+static bool Decode_Mask(const uint8_t *in, uint8_t len, uint8_t *used,
+                        uint32_t *mask) {
+  memset(mask, 0, 4 * sizeof(uint32_t));
+  if (len < 1)
+    return false;
+
+  uint8_t runs = in[0];
+  if (runs == 0) {
+    if (len < 17)
+      return false;
+    for (uint8_t w = 0; w < 4; w++) {
+      for (uint8_t b = 0; b < 4; b++) {
+        mask[w] |= (uint32_t)in[1 + w * 4 + b] << (8 * b);
+      }
+    }
+    *used = 17;
+    return true;
+  }
+
+  if (runs > CCD_TLM_MAX_MASK_RUNS || len < 1 + runs)
+    return false;
+  uint16_t pos = 0;
+  for (uint8_t r = 0; r < runs; r++) {
+    if (pos + in[1 + r] > 128)
+      return false;
+    for (uint8_t k = 0; k < in[1 + r]; k++, pos++) {
+      if (r & 1)
+        mask[pos >> 5] |= 1u << (pos & 31);
+    }
+  }
+  *used = 1 + runs;
+  return pos == 128;
+}
+
+static bool Decode_Delta(const uint8_t *in, uint8_t len,
+                         const uint8_t *reference, uint8_t *samples) {
+  uint8_t n = 0, i = 0;
+  while (i < 128) {
+    if (n >= len)
+      return false;
+    uint8_t token = in[n++];
+    uint8_t run = (token & 0x3F) + 1;
+    uint8_t bits = 0;
+    if (i + run > 128)
+      return false;
+
+    switch (token & 0xC0) {
+    case CCD_TLM_TOKEN_SMALL:
+      bits = 2;
+      break;
+    case CCD_TLM_TOKEN_NIBBLE:
+      bits = 4;
+      break;
+    case CCD_TLM_TOKEN_LITERAL:
+      bits = 8;
+      break;
+    default:
+      break;
+    }
+
+    uint8_t bytes = (run * bits + 7) / 8;
+    if (n + bytes > len)
+      return false;
+    if (bits == 0) {
+      memcpy(&samples[i], &reference[i], run);
+    } else if (bits == 8) {
+      memcpy(&samples[i], &in[n], run);
+    } else {
+      uint8_t field = (1 << bits) - 1;
+      for (uint8_t k = 0; k < run; k++) {
+        int8_t code = (in[n + k * bits / 8] >> ((k * bits) & 7)) & field;
+        if (code & (1 << (bits - 1))) // 符号扩展
+          code -= 1 << bits;
+        samples[i + k] = reference[i + k] + code;
+      }
+    }
+    n += bytes;
+    i += run;
+  }
+  return n == len;
+}
+
+// 解析一个完整的payload；差值帧的参考帧缺失时返回false
+static bool Decode_Payload(CCD_Tlm_Decoder *dec, CCD_Tlm_Frame *frame) {
+  const uint8_t *p = dec->payload;
+  uint8_t used;
+
+  if (dec->len < CCD_TLM_HEADER_SIZE + 1) {
+    dec->bad_frames++;
+    return false;
+  }
+  frame->type = p[0];
+  frame->seq = p[1];
+  frame->skipped = p[2];
+  frame->size = dec->len + 4;
+  frame->overlay.tick = p[3] | (p[4] << 8);
+  frame->overlay.median = p[5];
+  frame->overlay.left_edge = p[6];
+  frame->overlay.right_edge = p[7];
+  frame->overlay.line_width = p[8];
+  frame->overlay.threshold = p[9];
+  frame->overlay.exposure = p[10];
+
+  uint8_t n = CCD_TLM_HEADER_SIZE;
+  if (!Decode_Mask(&p[n], dec->len - n, &used, frame->mask)) {
+    dec->bad_frames++;
+    return false;
+  }
+  n += used;
+
+  dec->skipped += frame->skipped;
+
+  // 序号不连续说明中间丢了包，之后的差值帧都无法重建，等待下一个关键帧
+  bool in_sequence = dec->synced && frame->seq == (uint8_t)(dec->last_seq + 1);
+  dec->last_seq = frame->seq;
+
+  bool ok;
+  if (frame->type == CCD_TLM_KEYFRAME) {
+    ok = (dec->len - n == 128);
+    if (ok)
+      memcpy(frame->samples, &p[n], 128);
+  } else if (frame->type == CCD_TLM_DELTA) {
+    if (!in_sequence) {
+      dec->synced = false;
+      dec->dropped++;
+      return false;
+    }
+    ok = Decode_Delta(&p[n], dec->len - n, dec->reference, frame->samples);
+  } else {
+    ok = false;
+  }
+
+  if (!ok) {
+    dec->synced = false;
+    dec->bad_frames++;
+    return false;
+  }
+  memcpy(dec->reference, frame->samples, 128);
+  dec->synced = true;
+  dec->frames++;
+  return true;
+}
+
+// 逐字节输入接收数据，重建出一帧时返回true
+bool CCD_Tlm_Decode_Byte(CCD_Tlm_Decoder *dec, uint8_t byte,
+                         CCD_Tlm_Frame *frame) {
+  switch (dec->state) {
+  case TLM_WAIT_SYNC0:
+    if (byte == CCD_TLM_SYNC0)
+      dec->state = TLM_WAIT_SYNC1;
+    break;
+  case TLM_WAIT_SYNC1:
+    dec->state = (byte == CCD_TLM_SYNC1) ? TLM_WAIT_LEN
+                 : (byte == CCD_TLM_SYNC0) ? TLM_WAIT_SYNC1
+                                           : TLM_WAIT_SYNC0;
+    break;
+  case TLM_WAIT_LEN:
+    dec->len = byte;
+    dec->pos = 0;
+    dec->state = (byte > 0 && byte <= CCD_TLM_MAX_PAYLOAD) ? TLM_PAYLOAD
+                                                           : TLM_WAIT_SYNC0;
+    break;
+  case TLM_PAYLOAD:
+    dec->payload[dec->pos++] = byte;
+    if (dec->pos == dec->len)
+      dec->state = TLM_WAIT_CRC;
+    break;
+  case TLM_WAIT_CRC:
+    dec->state = TLM_WAIT_SYNC0;
+    if (byte != Crc8(Crc8(0, &dec->len, 1), dec->payload, dec->len)) {
+      dec->bad_frames++;
+      return false;
+    }
+    return Decode_Payload(dec, frame);
+  }
+  return false;
+}
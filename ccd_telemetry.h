@@ -0,0 +1,97 @@
+#ifndef __CCD_TELEMETRY_H
+#define __CCD_TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// CCD帧压缩遥测：关键帧发送完整采样，其余帧只发送与上一帧的差值，
+// 差值按零游程、2位/4位小差值、原始值四种记号编码；黑白掩码按游程编码
+// 纯算法模块，编码器在板上使用（见 bsp_ccd.c），
+// 解码器供 host/ccd_monitor.c 使用
+//
+// 包：SYNC0 SYNC1 len payload[len] crc8（覆盖len和payload，多项式0x07，初值0）
+// payload：type seq skip tick(2) median left right width threshold exposure
+//          runs mask[...] samples[...]
+//   seq：已编码的包序号；skip：上一个包之后因串口忙跳过、没有编码的帧数
+//   mask：runs个游程长度（从白色开始交替，首个可以为0）；
+//         runs为0时为16字节原始位图
+//   samples：关键帧为128个采样值，差值帧为记号序列
+// 同步字节与调参协议的0xA5不同，调参工具会跳过遥测包
+
+#define CCD_TLM_SYNC0 0x5A
+#define CCD_TLM_SYNC1 0xC3
+#define CCD_TLM_MAX_PAYLOAD 160
+#define CCD_TLM_MAX_PACKET (CCD_TLM_MAX_PAYLOAD + 4)
+#define CCD_TLM_HEADER_SIZE 11
+#define CCD_TLM_MAX_MASK_RUNS 16 // 游程数超过该值时改发原始位图
+#define CCD_TLM_KEYFRAME_INTERVAL 32
+
+// 帧类型
+#define CCD_TLM_KEYFRAME 0x01
+#define CCD_TLM_DELTA 0x02
+
+// 差值帧记号：高2位为类型，低6位为个数减1
+#define CCD_TLM_TOKEN_ZERO 0x00    // n个零差值，无后续字节
+#define CCD_TLM_TOKEN_SMALL 0x40   // n个-1..1的差值，每个2位，低位在前
+#define CCD_TLM_TOKEN_NIBBLE 0x80  // n个-8..7的差值，每个4位，低位在前
+#define CCD_TLM_TOKEN_LITERAL 0xC0 // n个原始采样值
+#define CCD_TLM_ZERO_RUN_MIN 8     // 连续零差值达到该长度才单独编码
+#define CCD_TLM_TOKEN_MAX_RUN 64
+
+// 检测结果叠加信息
+typedef struct {
+  uint16_t tick; // 采集时刻低16位 (ms)
+  uint8_t median;
+  uint8_t left_edge;
+  uint8_t right_edge;
+  uint8_t line_width;
+  uint8_t threshold;
+  uint8_t exposure;
+} CCD_Tlm_Overlay;
+
+typedef struct {
+  uint8_t reference[128]; // 上一个已编码帧（解码端持有相同副本）
+  uint8_t seq;
+  uint8_t skipped;   // 上一个包之后跳过的帧数（饱和到255）
+  uint8_t since_key; // 距上一个关键帧的帧数
+  uint8_t keyframe_interval;
+  bool need_key;
+} CCD_Tlm_Encoder;
+
+// 解码结果
+typedef struct {
+  uint8_t type;
+  uint8_t seq;
+  uint8_t skipped; // 本包之前发送端跳过的帧数
+  uint8_t size;    // 包总字节数
+  CCD_Tlm_Overlay overlay;
+  uint32_t mask[4];
+  uint8_t samples[128];
+} CCD_Tlm_Frame;
+
+typedef struct {
+  uint8_t state;
+  uint8_t len;
+  uint8_t pos;
+  uint8_t payload[CCD_TLM_MAX_PAYLOAD];
+  uint8_t reference[128];
+  bool synced; // 已收到关键帧，可以解码差值帧
+  uint8_t last_seq;
+  uint32_t frames;
+  uint32_t dropped;    // 因丢包或未同步而无法重建的帧
+  uint32_t skipped;    // 发送端因串口忙跳过的帧
+  uint32_t bad_frames; // 校验或格式错误
+} CCD_Tlm_Decoder;
+
+// 函数声明
+void CCD_Tlm_Encoder_Init(CCD_Tlm_Encoder *enc, uint8_t keyframe_interval);
+void CCD_Tlm_Request_Keyframe(CCD_Tlm_Encoder *enc);
+void CCD_Tlm_Skip_Frame(CCD_Tlm_Encoder *enc);
+uint16_t CCD_Tlm_Encode(CCD_Tlm_Encoder *enc, const uint8_t *samples,
+                        const uint32_t *mask, const CCD_Tlm_Overlay *overlay,
+                        uint8_t *packet);
+void CCD_Tlm_Decoder_Init(CCD_Tlm_Decoder *dec);
+bool CCD_Tlm_Decode_Byte(CCD_Tlm_Decoder *dec, uint8_t byte,
+                         CCD_Tlm_Frame *frame);
+
+#endif
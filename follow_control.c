@@ -0,0 +1,54 @@
+#include "follow_control.h"
+
+// 初始化跟随控制器
+void Follow_Control_Init(Follow_Control *fc, float target_gap,
+                         int16_t min_output, int16_t max_output) {
+  fc->target_gap = target_gap;
+  fc->kp = FOLLOW_KP;
+  fc->kd = FOLLOW_KD;
+  fc->pwm_per_cm_s = FOLLOW_PWM_PER_CM_S;
+  fc->min_output = min_output;
+  fc->max_output = max_output;
+  fc->accel_limit = FOLLOW_ACCEL_LIMIT;
+  fc->decel_limit = FOLLOW_DECEL_LIMIT;
+  fc->output = 0;
+}
+
+// 重置输出（切换模式时与实际电机输出对齐）
+void Follow_Control_Reset(Follow_Control *fc, int16_t output) {
+  fc->output = output;
+}
+
+// 计算跟随输出
+// gap: 当前间距 (cm)；closing_speed: 接近速度 (cm/s)，即本车速度减前车速度，
+// 正值为正在靠近；self_speed: 本车速度 (cm/s)；dt_ms: 距上次更新的时间
+// 阻尼项使本车速度不只靠标定的PWM-速度比跟上前车：
+// PWM-速度比标定偏大时本车比命令快，接近速度随之变大，命令相应减小
+int16_t Follow_Control_Update(Follow_Control *fc, float gap,
+                              float closing_speed, float self_speed,
+                              uint32_t dt_ms) {
+  // 前馈：目标速度 = 本车速度 - 接近速度
+  float leader_speed = self_speed - closing_speed;
+
+  // 反馈：间距偏大则加速追赶，偏小则减速；正在靠近时额外减速
+  float command = leader_speed + fc->kp * (gap - fc->target_gap) -
+                  fc->kd * closing_speed;
+  int32_t target = (int32_t)(command * fc->pwm_per_cm_s);
+
+  if (target > fc->max_output)
+    target = fc->max_output;
+  if (target < fc->min_output)
+    target = fc->min_output;
+
+  // 输出变化率限制，加速慢、减速快
+  int32_t max_up = fc->accel_limit * (int32_t)dt_ms / 1000;
+  int32_t max_down = fc->decel_limit * (int32_t)dt_ms / 1000;
+  int32_t delta = target - fc->output;
+  if (delta > max_up)
+    delta = max_up;
+  if (delta < -max_down)
+    delta = -max_down;
+
+  fc->output += delta;
+  return fc->output;
+}
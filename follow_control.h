@@ -0,0 +1,36 @@
+#ifndef __FOLLOW_CONTROL_H
+#define __FOLLOW_CONTROL_H
+
+#include <stdint.h>
+
+// 跟随控制器：间距误差反馈 + 目标速度前馈 + 速度差阻尼 + 输出变化率限制
+// 纯算法模块，不依赖HAL，可直接在主机上编译（见 host/follow_sim.c）
+
+// 默认参数
+#define FOLLOW_PWM_PER_CM_S 10.0f // 每cm/s车速对应的PWM（需实测标定）
+#define FOLLOW_KP 12.0f           // 间距误差增益 (1/s)
+#define FOLLOW_KD 1.0f            // 速度差阻尼（本车比前车快时额外减速）
+#define FOLLOW_ACCEL_LIMIT 4000   // 加速时PWM最大变化率 (每秒)
+#define FOLLOW_DECEL_LIMIT 12000  // 减速时PWM最大变化率 (每秒)
+
+typedef struct {
+  float target_gap; // 目标间距 (cm)
+  float kp;         // 间距误差增益 (1/s)
+  float kd;         // 速度差阻尼
+  float pwm_per_cm_s;
+  int16_t min_output; // 输出下限（负值允许后退）
+  int16_t max_output; // 输出上限
+  int32_t accel_limit;
+  int32_t decel_limit;
+  int16_t output;     // 当前输出（经变化率限制）
+} Follow_Control;
+
+// 函数声明
+void Follow_Control_Init(Follow_Control *fc, float target_gap,
+                         int16_t min_output, int16_t max_output);
+int16_t Follow_Control_Update(Follow_Control *fc, float gap,
+                              float closing_speed, float self_speed,
+                              uint32_t dt_ms);
+void Follow_Control_Reset(Follow_Control *fc, int16_t output);
+
+#endif
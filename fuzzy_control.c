@@ -0,0 +1,46 @@
+#include "fuzzy_control.h"
+
+#define FUZZY_GRID_MAX_Q8 ((FUZZY_GRID_SIZE - 1) << 8)
+
+// 将网格坐标（Q8）拆分为整数下标和小数部分，超出范围时夹到边界
+static void Grid_Split(int32_t pos_q8, uint8_t *index, int32_t *frac) {
+  if (pos_q8 < 0)
+    pos_q8 = 0;
+  if (pos_q8 >= FUZZY_GRID_MAX_Q8) {
+    *index = FUZZY_GRID_SIZE - 2;
+    *frac = 256;
+    return;
+  }
+  *index = pos_q8 >> 8;
+  *frac = pos_q8 & 0xFF;
+}
+
+static int32_t Lerp(int32_t a, int32_t b, int32_t frac) {
+  return a + (((b - a) * frac) >> 8);
+}
+
+// 查表并三线性插值得到左右电机速度
+void Fuzzy_Avoid_Lookup(float distance, uint16_t left_ir, uint16_t right_ir,
+                        int16_t *left_speed, int16_t *right_speed) {
+  uint8_t di, li, ri;
+  int32_t df, lf, rf;
+
+  Grid_Split((int32_t)(distance * (256.0f / FUZZY_DIST_STEP)), &di, &df);
+  Grid_Split(((int32_t)left_ir << 8) / FUZZY_IR_STEP, &li, &lf);
+  Grid_Split(((int32_t)right_ir << 8) / FUZZY_IR_STEP, &ri, &rf);
+
+  for (int out = 0; out < 2; out++) {
+    int32_t plane[2];
+    for (int d = 0; d < 2; d++) {
+      const int16_t(*cell)[FUZZY_GRID_SIZE][2] = Fuzzy_Avoid_Table[di + d];
+      int32_t lo = Lerp(cell[li][ri][out], cell[li][ri + 1][out], rf);
+      int32_t hi = Lerp(cell[li + 1][ri][out], cell[li + 1][ri + 1][out], rf);
+      plane[d] = Lerp(lo, hi, lf);
+    }
+    int16_t value = (int16_t)Lerp(plane[0], plane[1], df);
+    if (out == 0)
+      *left_speed = value;
+    else
+      *right_speed = value;
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef __FUZZY_CONTROL_H
+#define __FUZZY_CONTROL_H
+
+#include <stdint.h>
+
+// 避障模糊控制器：距离、左IR、右IR三个输入，左右电机两个输出
+// 控制曲面由 host/fuzzy_table_gen.c 在编译前离线计算成查找表（fuzzy_table.c），
+// 运行时只做三线性插值。修改下列参数后需重新生成查找表：
+//   gcc -I. -o fuzzy_table_gen host/fuzzy_table_gen.c -lm
+//   ./fuzzy_table_gen > fuzzy_table.c
+
+// 查找表网格（均匀网格，保证插值为O(1)）
+#define FUZZY_GRID_SIZE 9
+#define FUZZY_DIST_STEP 4.0f // 距离网格步长 (cm)，覆盖0-32cm
+#define FUZZY_IR_STEP 64     // IR网格步长 (ADC)，覆盖0-512
+
+// 隶属函数拐点（围绕原阈值 AVOID_DISTANCE 5cm、IR 100/200 设计）
+#define FUZZY_DIST_NEAR_FULL 3.0f // 完全"近"
+#define FUZZY_DIST_MID_PEAK 8.0f  // "中"的峰值
+#define FUZZY_DIST_FAR_FULL 16.0f // 完全"远"
+#define FUZZY_IR_CLOSE_FULL 80    // 完全"很近"
+#define FUZZY_IR_NEAR_PEAK 200    // "较近"的峰值
+#define FUZZY_IR_CLEAR_FULL 350   // 完全"无障碍"
+
+// 输出规则的速度单位
+#define FUZZY_FORWARD_SPEED 800 // 无障碍前进速度
+#define FUZZY_SLOW_SPEED 400    // 接近障碍减速速度
+#define FUZZY_BACK_SPEED -600   // 后退速度
+#define FUZZY_TURN_STEP 400     // 每级严重程度差对应的转向量
+
+// 查找表：[距离][左IR][右IR][左/右电机]
+extern const int16_t Fuzzy_Avoid_Table[FUZZY_GRID_SIZE][FUZZY_GRID_SIZE]
+                                      [FUZZY_GRID_SIZE][2];
+
+// 函数声明
+void Fuzzy_Avoid_Lookup(float distance, uint16_t left_ir, uint16_t right_ir,
+                        int16_t *left_speed, int16_t *right_speed);
+
+#endif
@@ -0,0 +1,107 @@
+// 自动生成文件，请勿手工修改
+// 生成方式见 fuzzy_control.h
+
+#include "fuzzy_control.h"
+
+const int16_t Fuzzy_Avoid_Table[FUZZY_GRID_SIZE][FUZZY_GRID_SIZE]
+                                [FUZZY_GRID_SIZE][2] = {
+    {
+        {{-600, -600}, {-600, -600}, {-440, -760}, {-227, -973}, {-51, -1000}, {120, -1000}, {200, -1000}, {200, -1000}, {200, -1000}},
+        {{-600, -600}, {-600, -600}, {-440, -760}, {-227, -973}, {-51, -1000}, {120, -1000}, {200, -1000}, {200, -1000}, {200, -1000}},
+        {{-760, -440}, {-760, -440}, {-600, -600}, {-387, -813}, {-211, -989}, {-40, -1000}, {40, -1000}, {40, -1000}, {40, -1000}},
+        {{-973, -227}, {-973, -227}, {-813, -387}, {-600, -600}, {-424, -776}, {-253, -947}, {-173, -1000}, {-173, -1000}, {-173, -1000}},
+        {{-1000, -51}, {-1000, -51}, {-989, -211}, {-776, -424}, {-600, -600}, {-429, -771}, {-349, -851}, {-349, -851}, {-349, -851}},
+        {{-1000, 120}, {-1000, 120}, {-1000, -40}, {-947, -253}, {-771, -429}, {-600, -600}, {-520, -680}, {-520, -680}, {-520, -680}},
+        {{-1000, 200}, {-1000, 200}, {-1000, 40}, {-1000, -173}, {-851, -349}, {-680, -520}, {-600, -600}, {-600, -600}, {-600, -600}},
+        {{-1000, 200}, {-1000, 200}, {-1000, 40}, {-1000, -173}, {-851, -349}, {-680, -520}, {-600, -600}, {-600, -600}, {-600, -600}},
+        {{-1000, 200}, {-1000, 200}, {-1000, 40}, {-1000, -173}, {-851, -349}, {-680, -520}, {-600, -600}, {-600, -600}, {-600, -600}},
+    },
+    {
+        {{-600, -600}, {-600, -600}, {-392, -712}, {-115, -861}, {69, -1000}, {240, -1000}, {320, -1000}, {320, -1000}, {320, -1000}},
+        {{-600, -600}, {-600, -600}, {-392, -712}, {-115, -861}, {69, -1000}, {240, -1000}, {320, -1000}, {320, -1000}, {320, -1000}},
+        {{-712, -392}, {-712, -392}, {-510, -510}, {-242, -668}, {-59, -837}, {112, -1000}, {192, -1000}, {192, -1000}, {192, -1000}},
+        {{-861, -115}, {-861, -115}, {-668, -242}, {-411, -411}, {-229, -581}, {-59, -752}, {21, -832}, {21, -832}, {21, -832}},
+        {{-1000, 69}, {-1000, 69}, {-837, -59}, {-581, -229}, {-400, -400}, {-229, -571}, {-149, -651}, {-149, -651}, {-149, -651}},
+        {{-1000, 240}, {-1000, 240}, {-1000, 112}, {-752, -59}, {-571, -229}, {-400, -400}, {-320, -480}, {-320, -480}, {-320, -480}},
+        {{-1000, 320}, {-1000, 320}, {-1000, 192}, {-832, 21}, {-651, -149}, {-480, -320}, {-400, -400}, {-400, -400}, {-400, -400}},
+        {{-1000, 320}, {-1000, 320}, {-1000, 192}, {-832, 21}, {-651, -149}, {-480, -320}, {-400, -400}, {-400, -400}, {-400, -400}},
+        {{-1000, 320}, {-1000, 320}, {-1000, 192}, {-832, 21}, {-651, -149}, {-480, -320}, {-400, -400}, {-400, -400}, {-400, -400}},
+    },
+    {
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-520, -200}, {-520, -200}, {-152, -152}, {339, -88}, {549, -229}, {720, -400}, {800, -480}, {800, -480}, {800, -480}},
+        {{-413, 333}, {-413, 333}, {-88, 339}, {346, 346}, {549, 197}, {720, 27}, {800, -53}, {800, -53}, {800, -53}},
+        {{-549, 549}, {-549, 549}, {-229, 549}, {197, 549}, {400, 400}, {571, 229}, {651, 149}, {651, 149}, {651, 149}},
+        {{-720, 720}, {-720, 720}, {-400, 720}, {27, 720}, {229, 571}, {400, 400}, {480, 320}, {480, 320}, {480, 320}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {149, 651}, {320, 480}, {400, 400}, {400, 400}, {400, 400}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {149, 651}, {320, 480}, {400, 400}, {400, 400}, {400, 400}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {149, 651}, {320, 480}, {400, 400}, {400, 400}, {400, 400}},
+    },
+    {
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-520, -200}, {-520, -200}, {-152, -152}, {339, -88}, {549, -229}, {720, -400}, {800, -480}, {800, -480}, {800, -480}},
+        {{-413, 333}, {-413, 333}, {-88, 339}, {346, 346}, {549, 197}, {720, 27}, {800, -53}, {800, -53}, {800, -53}},
+        {{-549, 549}, {-549, 549}, {-229, 549}, {197, 549}, {428, 428}, {630, 289}, {725, 224}, {725, 224}, {725, 224}},
+        {{-720, 720}, {-720, 720}, {-400, 720}, {27, 720}, {289, 630}, {528, 528}, {640, 480}, {640, 480}, {640, 480}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {224, 725}, {480, 640}, {600, 600}, {600, 600}, {600, 600}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {224, 725}, {480, 640}, {600, 600}, {600, 600}, {600, 600}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {224, 725}, {480, 640}, {600, 600}, {600, 600}, {600, 600}},
+    },
+    {
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-520, -200}, {-520, -200}, {-152, -152}, {339, -88}, {549, -229}, {720, -400}, {800, -480}, {800, -480}, {800, -480}},
+        {{-413, 333}, {-413, 333}, {-88, 339}, {346, 346}, {549, 197}, {720, 27}, {800, -53}, {800, -53}, {800, -53}},
+        {{-549, 549}, {-549, 549}, {-229, 549}, {197, 549}, {456, 456}, {690, 349}, {800, 299}, {800, 299}, {800, 299}},
+        {{-720, 720}, {-720, 720}, {-400, 720}, {27, 720}, {349, 690}, {656, 656}, {800, 640}, {800, 640}, {800, 640}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+    },
+    {
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-520, -200}, {-520, -200}, {-152, -152}, {339, -88}, {549, -229}, {720, -400}, {800, -480}, {800, -480}, {800, -480}},
+        {{-413, 333}, {-413, 333}, {-88, 339}, {346, 346}, {549, 197}, {720, 27}, {800, -53}, {800, -53}, {800, -53}},
+        {{-549, 549}, {-549, 549}, {-229, 549}, {197, 549}, {456, 456}, {690, 349}, {800, 299}, {800, 299}, {800, 299}},
+        {{-720, 720}, {-720, 720}, {-400, 720}, {27, 720}, {349, 690}, {656, 656}, {800, 640}, {800, 640}, {800, 640}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+    },
+    {
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-520, -200}, {-520, -200}, {-152, -152}, {339, -88}, {549, -229}, {720, -400}, {800, -480}, {800, -480}, {800, -480}},
+        {{-413, 333}, {-413, 333}, {-88, 339}, {346, 346}, {549, 197}, {720, 27}, {800, -53}, {800, -53}, {800, -53}},
+        {{-549, 549}, {-549, 549}, {-229, 549}, {197, 549}, {456, 456}, {690, 349}, {800, 299}, {800, 299}, {800, 299}},
+        {{-720, 720}, {-720, 720}, {-400, 720}, {27, 720}, {349, 690}, {656, 656}, {800, 640}, {800, 640}, {800, 640}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+    },
+    {
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-520, -200}, {-520, -200}, {-152, -152}, {339, -88}, {549, -229}, {720, -400}, {800, -480}, {800, -480}, {800, -480}},
+        {{-413, 333}, {-413, 333}, {-88, 339}, {346, 346}, {549, 197}, {720, 27}, {800, -53}, {800, -53}, {800, -53}},
+        {{-549, 549}, {-549, 549}, {-229, 549}, {197, 549}, {456, 456}, {690, 349}, {800, 299}, {800, 299}, {800, 299}},
+        {{-720, 720}, {-720, 720}, {-400, 720}, {27, 720}, {349, 690}, {656, 656}, {800, 640}, {800, 640}, {800, 640}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+    },
+    {
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-600, -600}, {-600, -600}, {-200, -520}, {333, -413}, {549, -549}, {720, -720}, {800, -800}, {800, -800}, {800, -800}},
+        {{-520, -200}, {-520, -200}, {-152, -152}, {339, -88}, {549, -229}, {720, -400}, {800, -480}, {800, -480}, {800, -480}},
+        {{-413, 333}, {-413, 333}, {-88, 339}, {346, 346}, {549, 197}, {720, 27}, {800, -53}, {800, -53}, {800, -53}},
+        {{-549, 549}, {-549, 549}, {-229, 549}, {197, 549}, {456, 456}, {690, 349}, {800, 299}, {800, 299}, {800, 299}},
+        {{-720, 720}, {-720, 720}, {-400, 720}, {27, 720}, {349, 690}, {656, 656}, {800, 640}, {800, 640}, {800, 640}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+        {{-800, 800}, {-800, 800}, {-480, 800}, {-53, 800}, {299, 800}, {640, 800}, {800, 800}, {800, 800}, {800, 800}},
+    },
+};
@@ -0,0 +1,62 @@
+#ifndef __BSP_H
+#define __BSP_H
+
+// 主机替身：在Linux上编译固件模块时代替板级bsp.h（编译时加 -Ihost）
+// 只提供固件模块实际用到的接口，电机命令按时间线记录下来供仿真和检查
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ABS(x) ((x) < 0 ? -(x) : (x))
+
+// 电机
+typedef enum {
+  MOTOR_ID_M1 = 0,
+  MOTOR_ID_M2,
+  MOTOR_ID_M3,
+  MOTOR_ID_M4,
+  MOTOR_ID_MAX
+} Motor_ID;
+
+// 定时器寄存器替身（只用到CR1）
+typedef struct {
+  volatile uint32_t CR1;
+} TIM_TypeDef;
+
+#define TIM_CR1_UDIS (1u << 1)
+extern TIM_TypeDef host_tim1, host_tim8;
+#define TIM1 (&host_tim1)
+#define TIM8 (&host_tim8)
+
+// 主机上按推定的接线启用四路批量写入，由时间线检查屏蔽更新事件的逻辑
+#define MOTOR_PWM_TIM_A TIM8 // M1、M2
+#define MOTOR_PWM_TIM_B TIM1 // M3、M4
+
+// 电机命令时间线记录
+#define HOST_MOTOR_TIMELINE_SIZE 65536
+
+typedef struct {
+  uint32_t tick;   // 命令生效时刻 (ms)
+  int16_t pwm[4];  // 四路输出
+  uint8_t changed; // 本次更新中被写入的通道（按位）
+  bool split;      // 四路写入跨越了更新事件（未屏蔽UDIS）
+} Host_Motor_Event;
+
+void Motor_Set_Pwm(uint8_t id, int16_t speed);
+void Motor_Stop(uint8_t brake);
+
+// 系统时钟
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+
+// 主机侧控制接口
+void Host_Set_Tick(uint32_t tick);
+void Host_Advance_Tick(uint32_t ms);
+const int16_t *Host_Motor_Pwm(void);
+const Host_Motor_Event *Host_Motor_Timeline(uint32_t *count);
+void Host_Motor_Timeline_Clear(void);
+void Host_Motor_Timeline_Dump(FILE *out);
+
+#endif
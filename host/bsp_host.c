@@ -0,0 +1,75 @@
+// 主机替身实现：系统时钟由仿真程序推进，电机命令按更新事件记录成时间线
+
+#include "bsp.h"
+
+TIM_TypeDef host_tim1, host_tim8;
+
+static uint32_t host_tick = 0;
+static int16_t motor_pwm[4] = {0};
+static Host_Motor_Event timeline[HOST_MOTOR_TIMELINE_SIZE];
+static uint32_t timeline_count = 0;
+
+static bool Update_Disabled(void) {
+  return (host_tim1.CR1 & TIM_CR1_UDIS) || (host_tim8.CR1 & TIM_CR1_UDIS);
+}
+
+// 记录一次命令：同一时刻、屏蔽更新事件期间的写入合并为一条
+static void Record(uint8_t channel_mask) {
+  Host_Motor_Event *last =
+      (timeline_count > 0) ? &timeline[timeline_count - 1] : NULL;
+
+  if (last != NULL && last->tick == host_tick && Update_Disabled() &&
+      !(last->changed & channel_mask)) {
+    memcpy(last->pwm, motor_pwm, sizeof(motor_pwm));
+    last->changed |= channel_mask;
+    return;
+  }
+
+  if (timeline_count >= HOST_MOTOR_TIMELINE_SIZE)
+    return;
+
+  Host_Motor_Event *event = &timeline[timeline_count++];
+  event->tick = host_tick;
+  memcpy(event->pwm, motor_pwm, sizeof(motor_pwm));
+  event->changed = channel_mask;
+  event->split = !Update_Disabled() && channel_mask != 0x0F;
+}
+
+void Motor_Set_Pwm(uint8_t id, int16_t speed) {
+  if (id >= MOTOR_ID_MAX)
+    return;
+  motor_pwm[id] = speed;
+  Record(1u << id);
+}
+
+void Motor_Stop(uint8_t brake) {
+  (void)brake;
+  memset(motor_pwm, 0, sizeof(motor_pwm));
+  Record(0x0F);
+}
+
+uint32_t HAL_GetTick(void) { return host_tick; }
+
+void HAL_Delay(uint32_t ms) { host_tick += ms; }
+
+void Host_Set_Tick(uint32_t tick) { host_tick = tick; }
+
+void Host_Advance_Tick(uint32_t ms) { host_tick += ms; }
+
+const int16_t *Host_Motor_Pwm(void) { return motor_pwm; }
+
+const Host_Motor_Event *Host_Motor_Timeline(uint32_t *count) {
+  *count = timeline_count;
+  return timeline;
+}
+
+void Host_Motor_Timeline_Clear(void) { timeline_count = 0; }
+
+// 以文本形式输出时间线：tick m1 m2 m3 m4 changed split
+void Host_Motor_Timeline_Dump(FILE *out) {
+  for (uint32_t i = 0; i < timeline_count; i++) {
+    const Host_Motor_Event *e = &timeline[i];
+    fprintf(out, "%u %d %d %d %d %x %d\n", e->tick, e->pwm[0], e->pwm[1],
+            e->pwm[2], e->pwm[3], e->changed, e->split);
+  }
+}
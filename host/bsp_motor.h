@@ -0,0 +1,7 @@
+#ifndef __BSP_MOTOR_H
+#define __BSP_MOTOR_H
+
+// 主机替身：电机接口已在 host/bsp.h 中声明
+#include "bsp.h"
+
+#endif
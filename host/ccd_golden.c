@@ -0,0 +1,467 @@
+// 中线检测基准：在带标注的帧集上运行 ccd_process.c 的平滑和 Find_CCD_Median，
+// 统计中线误差、漏检、误检和每帧耗时，可与保存的基线比较，退化时返回非0
+// 用法：gcc -O2 -Ihost -I. -o ccd_golden host/ccd_golden.c ccd_process.c -lm
+//       ./ccd_golden [-n 每类帧数] [-s 种子] [-w 基线] [-c 基线] [-T]
+//                    [帧文件...]
+//       -w 把本次结果写成基线（修改检测算法前先跑一次）
+//       -c 与基线比较，任一类退化时返回1；-T 不比较耗时（换机器或机器繁忙时）
+// 内置帧集按固定种子合成，成像模型与 host/track_sim.c 相同，真值已知：
+//   normal 正常  glare 反光  lowlight 弱光  worn 磨损线  crossing 十字横线
+//   lost 无线（只有污渍和接缝）
+// 帧文件每行"真值中线 曝光 128个采样"，无线时真值为-1，#开头为注释，
+// 可以用 ccd_monitor -o 录下的帧手工加上真值
+// 判定：有线时检出且误差不超过 GOLDEN_HIT_PX 为命中，未检出为漏检，
+//       检出但误差过大或在无线帧上检出为误检
+
+#include "bsp_ccd.h"
+#include "track_sim.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define GOLDEN_FRAMES_PER_CLASS 500
+#define GOLDEN_HIT_PX 3.0f     // 命中判定的最大中线误差 (像素)
+#define GOLDEN_LINE_PX 12.2f   // 黑线标称宽度 (像素)
+#define GOLDEN_TIMING_ROUNDS 9 // 耗时取多轮中的最小值
+#define GOLDEN_TIMING_REPEAT 20
+#define GOLDEN_RATE_SLACK 0.5f // 漏检、误检比例允许的增加 (百分点)
+#define GOLDEN_ERROR_SLACK 0.1f // 平均误差允许的增加 (像素)
+#define GOLDEN_TIME_SLACK 1.3f  // 耗时允许的倍数
+#define GOLDEN_MAX_CLASSES 16
+#define GOLDEN_PI 3.14159265f
+
+// 一帧样本
+typedef struct {
+  uint8_t pixels[128];
+  uint8_t exposure;
+  float truth; // 真值中线（像素），<0 表示没有可跟随的线
+} Golden_Frame;
+
+// 一类样本及其统计
+typedef struct {
+  char name[32];
+  Golden_Frame *frames;
+  int count;
+  int lines;  // 有线的帧数
+  int hits;   // 命中
+  int misses; // 漏检
+  int falses; // 误检
+  float error_sum;
+  float error_max;
+  double ns_per_frame;
+} Golden_Class;
+
+static Golden_Class classes[GOLDEN_MAX_CLASSES];
+static int class_count = 0;
+static const Golden_Frame *current_frame; // RD_TSL的数据来源
+
+// ---------------------------------------------------------------------------
+// 帧合成
+
+static uint32_t rng_state;
+
+static float Rand_Uniform(void) {
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return (rng_state >> 8) / 16777216.0f;
+}
+
+static float Rand_Range(float lo, float hi) {
+  return lo + (hi - lo) * Rand_Uniform();
+}
+
+static float Rand_Gauss(void) {
+  float u1 = Rand_Uniform() + 1e-7f;
+  float u2 = Rand_Uniform();
+  return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * GOLDEN_PI * u2);
+}
+
+// 合成场景：每个像素的反射率、照度和与反射率无关的镜面反光
+typedef struct {
+  float reflect[256]; // 每像素两个子采样
+  float light[128];
+  float specular[128];
+  float noise;
+  uint8_t exposure;
+} Golden_Scene;
+
+static void Scene_Init(Golden_Scene *s, float light, float gradient) {
+  for (int k = 0; k < 256; k++) {
+    s->reflect[k] = SIM_WHITE * (1.0f + 0.02f * Rand_Gauss()); // 地面纹理
+  }
+  for (int i = 0; i < 128; i++) {
+    s->light[i] = light * (1.0f + gradient * (i - 63.5f) / 128.0f);
+    s->specular[i] = 0.0f;
+  }
+  s->noise = 1.0f;
+  s->exposure = 10;
+}
+
+// 在[center-width/2, center+width/2]内涂上反射率reflect
+static void Scene_Paint(Golden_Scene *s, float center, float width,
+                        float reflect) {
+  for (int k = 0; k < 256; k++) {
+    float x = (k >> 1) + ((k & 1) - 0.5f) * 0.5f;
+    if (fabsf(x - center) <= width / 2)
+      s->reflect[k] = reflect;
+  }
+}
+
+// 选择曝光时间：曝光控制在目标上下限之间不再调整，
+// 白色读数可能停在其中任意位置，这里取上半段（弱光类会被曝光上限截住）
+static void Scene_Expose(Golden_Scene *s) {
+  float light = 0.0f;
+  for (int i = 0; i < 128; i++) {
+    light += s->light[i] / 128;
+  }
+  float target =
+      Rand_Range((TARGET_MIN_VALUE + TARGET_MAX_VALUE) / 2, TARGET_MAX_VALUE) *
+      16.0f;
+  float exposure = target / (SIM_WHITE * light * SIM_ADC_PER_EXPOSURE);
+  if (exposure < MIN_EXPOSURE_TIME)
+    exposure = MIN_EXPOSURE_TIME;
+  if (exposure > MAX_EXPOSURE_TIME)
+    exposure = MAX_EXPOSURE_TIME;
+  s->exposure = (uint8_t)exposure;
+}
+
+static void Scene_Render(const Golden_Scene *s, Golden_Frame *f) {
+  for (int i = 0; i < 128; i++) {
+    float u = (i - 63.5f) / 63.5f;
+    float gain = 1.0f - SIM_VIGNETTING * u * u;
+    float reflect = (s->reflect[2 * i] + s->reflect[2 * i + 1]) / 2;
+    float adc = (reflect * s->light[i] + s->specular[i]) * gain * s->exposure *
+                    SIM_ADC_PER_EXPOSURE +
+                SIM_PIXEL_NOISE * s->noise * Rand_Gauss();
+    if (adc < 0.0f)
+      adc = 0.0f;
+    if (adc > 4095.0f)
+      adc = 4095.0f;
+    f->pixels[i] = (uint16_t)adc >> 4;
+  }
+  f->exposure = s->exposure;
+}
+
+// 按类别合成一帧
+static void Make_Frame(const char *name, Golden_Frame *f) {
+  Golden_Scene s;
+  float center = Rand_Range(8.0f, 120.0f);
+  float width = GOLDEN_LINE_PX * Rand_Range(0.85f, 1.2f); // 含线倾斜
+  float black = SIM_BLACK;
+
+  Scene_Init(&s, Rand_Range(0.8f, 1.2f), Rand_Range(-0.3f, 0.3f));
+  f->truth = center;
+
+  if (strcmp(name, "glare") == 0) {
+    // 灯光在地面和胶带上的镜面反光，峰值可使像素饱和
+    float spot = center + Rand_Range(-25.0f, 25.0f);
+    float sigma = Rand_Range(4.0f, 15.0f), peak = Rand_Range(0.3f, 1.5f);
+    for (int i = 0; i < 128; i++) {
+      float d = (i - spot) / sigma;
+      s.specular[i] = peak * expf(-d * d);
+    }
+    Scene_Paint(&s, center, width, black);
+    Scene_Expose(&s);
+  } else if (strcmp(name, "lowlight") == 0) {
+    // 照度低到曝光上限也补不回来，噪声相对变大
+    for (int i = 0; i < 128; i++) {
+      s.light[i] *= Rand_Range(0.06f, 0.12f);
+    }
+    s.noise = Rand_Range(1.0f, 2.0f);
+    Scene_Paint(&s, center, width, black);
+    Scene_Expose(&s);
+  } else if (strcmp(name, "worn") == 0) {
+    // 磨损的胶带：整体变浅，局部露出地面
+    Scene_Paint(&s, center, width, Rand_Range(0.2f, 0.45f));
+    for (int k = 0; k < 3; k++) {
+      if (Rand_Uniform() < 0.5f)
+        Scene_Paint(&s, center + Rand_Range(-width / 2, width / 2),
+                    Rand_Range(0.5f, 2.0f), Rand_Range(0.45f, 0.7f));
+    }
+    Scene_Expose(&s);
+  } else if (strcmp(name, "crossing") == 0) {
+    // 压在十字横线上：大片黑色，不应当作中线
+    float band = Rand_Range(60.0f, 140.0f);
+    Scene_Paint(&s, Rand_Range(band / 2 - 10, 138 - band / 2), band, black);
+    Scene_Expose(&s);
+    f->truth = -1.0f;
+  } else if (strcmp(name, "lost") == 0) {
+    // 只有地面：浅色污渍和地板接缝
+    int stains = (int)Rand_Range(0.0f, 4.0f);
+    for (int k = 0; k < stains; k++) {
+      Scene_Paint(&s, Rand_Range(0, 128), Rand_Range(2.0f, 8.0f),
+                  Rand_Range(0.5f, 0.7f));
+    }
+    if (Rand_Uniform() < 0.5f)
+      Scene_Paint(&s, Rand_Range(0, 128), Rand_Range(0.5f, 1.5f), 0.3f);
+    Scene_Expose(&s);
+    f->truth = -1.0f;
+  } else {
+    Scene_Paint(&s, center, width, black);
+    Scene_Expose(&s);
+  }
+  Scene_Render(&s, f);
+}
+
+static Golden_Class *Add_Class(const char *name) {
+  if (class_count == GOLDEN_MAX_CLASSES)
+    return NULL;
+  Golden_Class *c = &classes[class_count++];
+  memset(c, 0, sizeof(*c));
+  snprintf(c->name, sizeof(c->name), "%s", name);
+  return c;
+}
+
+static bool Build_Synthetic(const char *name, int count, uint32_t seed) {
+  Golden_Class *c = Add_Class(name);
+  if (c == NULL || (c->frames = calloc(count, sizeof(Golden_Frame))) == NULL)
+    return false;
+  rng_state = seed;
+  for (c->count = 0; c->count < count; c->count++) {
+    Make_Frame(name, &c->frames[c->count]);
+  }
+  return true;
+}
+
+// 读取带标注的帧文件，每个文件为一类
+static bool Load_File(const char *path) {
+  char line[1024];
+  int capacity = 0;
+  FILE *file = fopen(path, "r");
+  const char *base = strrchr(path, '/');
+  Golden_Class *c = Add_Class(base ? base + 1 : path);
+
+  if (file == NULL || c == NULL)
+    return false;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    char *p = line, *end;
+    if (line[0] == '#')
+      continue;
+    float truth = strtof(p, &end);
+    if (end == p)
+      continue;
+    long exposure = strtol(p = end, &end, 10);
+    if (end == p || exposure <= 0 || exposure > 255)
+      continue;
+
+    if (c->count == capacity) {
+      capacity = capacity ? capacity * 2 : 256;
+      Golden_Frame *frames = realloc(c->frames, capacity * sizeof(*frames));
+      if (frames == NULL) {
+        fclose(file);
+        return false;
+      }
+      c->frames = frames;
+    }
+    Golden_Frame *f = &c->frames[c->count];
+    int i;
+    for (i = 0, p = end; i < 128; i++, p = end) {
+      long value = strtol(p, &end, 10);
+      if (end == p)
+        break;
+      f->pixels[i] = (value < 0) ? 0 : (value > 255) ? 255 : value;
+    }
+    if (i == 128) {
+      f->exposure = (uint8_t)exposure;
+      f->truth = truth;
+      c->count++;
+    }
+  }
+  fclose(file);
+  return c->count > 0;
+}
+
+// ---------------------------------------------------------------------------
+// 评估
+
+// 代替硬件采集：提供当前样本帧
+void RD_TSL(void) { memcpy(ccd.raw_data, current_frame->pixels, 128); }
+
+// 处理一帧，返回检出的中线（未检出时返回-1）
+static int Detect(const Golden_Frame *f) {
+  memset(&ccd, 0, sizeof(ccd));
+  ccd.exposure_time = f->exposure;
+  CCD_median = 64;
+  current_frame = f;
+  Deal_Data_CCD();
+  return (ccd.line_width > 0) ? CCD_median : -1;
+}
+
+static double Now_Ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void Evaluate(Golden_Class *c) {
+  for (int k = 0; k < c->count; k++) {
+    const Golden_Frame *f = &c->frames[k];
+    int median = Detect(f);
+    if (f->truth < 0) {
+      if (median >= 0)
+        c->falses++;
+      continue;
+    }
+    c->lines++;
+    float error = fabsf(median - f->truth);
+    if (median < 0) {
+      c->misses++;
+    } else if (error > GOLDEN_HIT_PX) {
+      c->falses++;
+    } else {
+      c->hits++;
+      c->error_sum += error;
+      if (error > c->error_max)
+        c->error_max = error;
+    }
+  }
+
+  // 耗时：逐帧完整处理（复制、平滑、中线检测、曝光控制），多轮取最小
+  double best = 1e30;
+  for (int round = 0; round < GOLDEN_TIMING_ROUNDS; round++) {
+    double start = Now_Ns();
+    for (int r = 0; r < GOLDEN_TIMING_REPEAT; r++) {
+      for (int k = 0; k < c->count; k++) {
+        current_frame = &c->frames[k];
+        Deal_Data_CCD();
+      }
+    }
+    double ns = (Now_Ns() - start) / (GOLDEN_TIMING_REPEAT * c->count);
+    if (ns < best)
+      best = ns;
+  }
+  c->ns_per_frame = best;
+}
+
+static float Rate(int n, int total) {
+  return total ? 100.0f * n / total : 0.0f;
+}
+
+static float Mean_Error(const Golden_Class *c) {
+  return c->hits ? c->error_sum / c->hits : 0.0f;
+}
+
+static bool Write_Baseline(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (file == NULL)
+    return false;
+  fprintf(file, "# class miss%% false%% mean(px) ns/frame\n");
+  for (int k = 0; k < class_count; k++) {
+    const Golden_Class *c = &classes[k];
+    fprintf(file, "%s %.2f %.2f %.3f %.1f\n", c->name,
+            Rate(c->misses, c->count), Rate(c->falses, c->count),
+            Mean_Error(c), c->ns_per_frame);
+  }
+  fclose(file);
+  return true;
+}
+
+// 与基线逐类比较，返回退化的项数（基线中没有的类跳过）
+static int Compare_Baseline(const char *path, bool timing) {
+  char line[256], name[64];
+  float miss, falses, error;
+  double ns;
+  int regressions = 0;
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 1;
+  }
+
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (line[0] == '#' || sscanf(line, "%63s %f %f %f %lf", name, &miss,
+                                 &falses, &error, &ns) != 5)
+      continue;
+    for (int k = 0; k < class_count; k++) {
+      const Golden_Class *c = &classes[k];
+      if (strcmp(c->name, name) != 0)
+        continue;
+      if (Rate(c->misses, c->count) > miss + GOLDEN_RATE_SLACK) {
+        printf("REGRESSION %s: miss %.2f%% (was %.2f%%)\n", name,
+               Rate(c->misses, c->count), miss);
+        regressions++;
+      }
+      if (Rate(c->falses, c->count) > falses + GOLDEN_RATE_SLACK) {
+        printf("REGRESSION %s: false %.2f%% (was %.2f%%)\n", name,
+               Rate(c->falses, c->count), falses);
+        regressions++;
+      }
+      if (Mean_Error(c) > error + GOLDEN_ERROR_SLACK) {
+        printf("REGRESSION %s: mean error %.3f px (was %.3f)\n", name,
+               Mean_Error(c), error);
+        regressions++;
+      }
+      if (timing && c->ns_per_frame > ns * GOLDEN_TIME_SLACK) {
+        printf("REGRESSION %s: %.1f ns/frame (was %.1f)\n", name,
+               c->ns_per_frame, ns);
+        regressions++;
+      }
+    }
+  }
+  fclose(file);
+  return regressions;
+}
+
+int main(int argc, char **argv) {
+  static const char *synthetic[] = {"normal",   "glare", "lowlight",
+                                    "worn",     "crossing", "lost"};
+  int per_class = GOLDEN_FRAMES_PER_CLASS;
+  uint32_t seed = 1;
+  const char *write_path = NULL, *compare_path = NULL;
+  bool timing = true;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      per_class = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+      write_path = argv[++i];
+    } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+      compare_path = argv[++i];
+    } else if (strcmp(argv[i], "-T") == 0) {
+      timing = false;
+    } else if (!Load_File(argv[i])) {
+      fprintf(stderr, "cannot load %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  // 各类使用不同的种子，增减类别不影响其余类的帧
+  for (int k = 0; k < (int)(sizeof(synthetic) / sizeof(synthetic[0])); k++) {
+    if (!Build_Synthetic(synthetic[k], per_class, seed * 7919u + k)) {
+      fprintf(stderr, "out of memory\n");
+      return 1;
+    }
+  }
+
+  printf("%-10s %6s %5s %5s %5s %6s %8s %7s %9s\n", "class", "frames", "line",
+         "miss%", "false%", "hit%", "mean(px)", "max(px)", "ns/frame");
+  int total = 0, hits = 0, lines = 0, misses = 0, falses = 0;
+  for (int k = 0; k < class_count; k++) {
+    Golden_Class *c = &classes[k];
+    Evaluate(c);
+    printf("%-10s %6d %5d %5.1f %6.1f %6.1f %8.2f %7.1f %9.1f\n", c->name,
+           c->count, c->lines, Rate(c->misses, c->count),
+           Rate(c->falses, c->count), Rate(c->hits, c->lines), Mean_Error(c),
+           c->error_max, c->ns_per_frame);
+    total += c->count;
+    lines += c->lines;
+    hits += c->hits;
+    misses += c->misses;
+    falses += c->falses;
+  }
+  printf("total %d frames, hit %.1f%% of lines, miss %d, false %d\n", total,
+         Rate(hits, lines), misses, falses);
+
+  if (write_path != NULL && !Write_Baseline(write_path)) {
+    fprintf(stderr, "cannot write %s\n", write_path);
+    return 1;
+  }
+  if (compare_path != NULL) {
+    int regressions = Compare_Baseline(compare_path, timing);
+    printf("%s\n", regressions ? "FAIL" : "PASS");
+    return regressions ? 1 : 0;
+  }
+  return 0;
+}
@@ -0,0 +1,191 @@
+// CCD遥测监视：解码 ccd_telemetry.h 中的压缩帧，实时显示波形和检测结果
+// 用法：gcc -O2 -I. -o ccd_monitor host/ccd_monitor.c ccd_telemetry.c
+//       ./ccd_monitor <串口|抓包文件> [-b 波特率] [-o 日志] [-q]
+//       -o 把每帧写成CCD日志（"曝光 128个采样"，可交给 gain_opt 回放；
+//          注意遥测中的采样已经平滑过，回放时会再平滑一次）
+//       -q 不逐帧显示，只输出统计
+// 小车上先用 param_tool 打开遥测：set tel.on 1
+// 每帧一行：'#'黑 '.'白 '|'边缘 'M'中线，
+//         行尾为序号、时刻、中线、线宽、阈值、曝光（关键帧加K）
+// 每秒输出一次统计：帧率、平均包长、小车因串口忙跳过的帧、
+//                   丢帧（丢包后等待关键帧）、校验错误
+
+#include "ccd_telemetry.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define MONITOR_STATS_MS 1000
+
+typedef struct {
+  uint32_t frames;
+  uint32_t bytes;
+  uint32_t keyframes;
+} Monitor_Stats;
+
+static speed_t Baud_Constant(long baud) {
+  switch (baud) {
+  case 9600:
+    return B9600;
+  case 57600:
+    return B57600;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  default:
+    return B115200;
+  }
+}
+
+// 字符设备按串口配置，其余按抓包文件读取
+static int Open_Input(const char *path, long baud) {
+  struct termios tio;
+  struct stat st;
+  int fd = open(path, O_RDONLY | O_NOCTTY);
+  if (fd < 0 || fstat(fd, &st) != 0)
+    return -1;
+  if (!S_ISCHR(st.st_mode))
+    return fd;
+  if (tcgetattr(fd, &tio) != 0)
+    return -1;
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, Baud_Constant(baud));
+  cfsetospeed(&tio, Baud_Constant(baud));
+  tio.c_cc[VMIN] = 1;
+  tio.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &tio);
+  tcflush(fd, TCIFLUSH);
+  return fd;
+}
+
+static void Show_Frame(const CCD_Tlm_Frame *frame) {
+  char line[129];
+  const CCD_Tlm_Overlay *o = &frame->overlay;
+
+  for (int i = 0; i < 128; i++) {
+    bool black = (frame->mask[i >> 5] >> (i & 31)) & 1u;
+    line[i] = black ? '#' : '.';
+  }
+  if (o->left_edge < 128)
+    line[o->left_edge] = '|';
+  if (o->right_edge < 128)
+    line[o->right_edge] = '|';
+  if (o->median < 128)
+    line[o->median] = 'M';
+  line[128] = '\0';
+  printf("%s %3u %5u m%3u w%2u t%3u e%2u%s\n", line, frame->seq, o->tick,
+         o->median, o->line_width, o->threshold, o->exposure,
+         frame->type == CCD_TLM_KEYFRAME ? " K" : "");
+}
+
+static void Log_Frame(FILE *log, const CCD_Tlm_Frame *frame) {
+  fprintf(log, "%u", frame->overlay.exposure);
+  for (int i = 0; i < 128; i++) {
+    fprintf(log, " %u", frame->samples[i]);
+  }
+  fprintf(log, "\n");
+}
+
+static void Show_Stats(const Monitor_Stats *stats, const CCD_Tlm_Decoder *dec,
+                       uint32_t elapsed_ms) {
+  printf("# %.1f fps  %.1f B/frame  key %u  skipped %u  dropped %u  bad %u\n",
+         elapsed_ms ? stats->frames * 1000.0 / elapsed_ms : 0.0,
+         stats->frames ? (double)stats->bytes / stats->frames : 0.0,
+         stats->keyframes, dec->skipped, dec->dropped, dec->bad_frames);
+  fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+  const char *path = NULL, *log_path = NULL;
+  long baud = 115200;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+      baud = atol(argv[++i]);
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      log_path = argv[++i];
+    else if (strcmp(argv[i], "-q") == 0)
+      quiet = true;
+    else
+      path = argv[i];
+  }
+  if (path == NULL) {
+    fprintf(stderr, "usage: %s <port|capture> [-b baud] [-o log] [-q]\n",
+            argv[0]);
+    return 1;
+  }
+
+  int fd = Open_Input(path, baud);
+  if (fd < 0) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+  FILE *log = NULL;
+  if (log_path != NULL && (log = fopen(log_path, "w")) == NULL) {
+    fprintf(stderr, "cannot write %s\n", log_path);
+    return 1;
+  }
+  if (log != NULL)
+    fprintf(log, "# ccd_monitor %s\n", path);
+
+  CCD_Tlm_Decoder dec;
+  CCD_Tlm_Frame frame;
+  Monitor_Stats window = {0}, total = {0};
+  uint16_t window_start = 0;
+  uint32_t total_ms = 0;
+  bool started = false;
+  uint8_t buffer[256];
+  ssize_t n;
+
+  CCD_Tlm_Decoder_Init(&dec);
+  while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+    for (ssize_t k = 0; k < n; k++) {
+      if (!CCD_Tlm_Decode_Byte(&dec, buffer[k], &frame))
+        continue;
+
+      window.frames++;
+      window.bytes += frame.size;
+      if (frame.type == CCD_TLM_KEYFRAME)
+        window.keyframes++;
+      if (!quiet)
+        Show_Frame(&frame);
+      if (log != NULL)
+        Log_Frame(log, &frame);
+
+      // 按小车时刻（16位，回绕）统计，抓包文件回放时同样有效
+      if (!started) {
+        window_start = frame.overlay.tick;
+        started = true;
+      }
+      uint16_t elapsed = frame.overlay.tick - window_start;
+      if (elapsed >= MONITOR_STATS_MS) {
+        Show_Stats(&window, &dec, elapsed);
+        total.frames += window.frames;
+        total.bytes += window.bytes;
+        total.keyframes += window.keyframes;
+        total_ms += elapsed;
+        memset(&window, 0, sizeof(window));
+        window_start = frame.overlay.tick;
+      }
+    }
+  }
+
+  total.frames += window.frames;
+  total.bytes += window.bytes;
+  total.keyframes += window.keyframes;
+  if (started)
+    total_ms += (uint16_t)(frame.overlay.tick - window_start);
+  printf("# total %u frames\n", total.frames);
+  Show_Stats(&total, &dec, total_ms);
+
+  if (log != NULL)
+    fclose(log);
+  close(fd);
+  return 0;
+}
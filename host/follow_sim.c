@@ -0,0 +1,267 @@
+// 跟随控制主机仿真：按脚本生成前车轨迹，比较原分段线性跟随与前馈跟随控制器
+// 控制路径与超声跟随避障.c一致：测距检验、定点卡尔曼、停止/跟随/丢失距离
+// 门限，本车速度和累计距离取编码器计数经里程计差分，前车速度由前车绝对位置
+// 的滤波得到；车辆模型的PWM-速度比与控制器的标定值
+// 故意不同（偏大、偏小各跑一次）
+// 用法：gcc -O2 -I. -o follow_sim host/follow_sim.c follow_control.c
+//           kalman_filter.c range_validator.c odometry.c -lm
+//       ./follow_sim [seed]
+// 前馈跟随在任一场景中撞上前车时输出 FAIL 并返回1，否则输出 PASS 并返回0
+
+#include "follow_control.h"
+#include "kalman_filter.h"
+#include "odometry.h"
+#include "range_validator.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// 与超声跟随避障.c一致的参数
+#define FOLLOW_STOP_DISTANCE 2.0f
+#define FOLLOW_MAX_DISTANCE 10.0f
+#define FOLLOW_LOST_DISTANCE 20.0f
+#define FOLLOW_BASE_DISTANCE 5.5f
+#define BASE_SPEED 800
+#define MAX_SPEED 2000
+#define SPEED_STEP 100
+#define MIN_SPEED 300
+#define RANGE_KF_Q 2000.0f
+#define RANGE_KF_R 0.1f
+#define RANGE_KF_DT_MS 20
+
+// 仿真参数
+#define SIM_DURATION_MS 20000
+#define CONTROL_PERIOD_MS 20 // 主循环周期（含一次阻塞测距）
+#define MOTOR_TAU_S 0.15f    // 电机一阶响应时间常数
+#define MOTOR_DEADBAND 250   // 低于该PWM车轮不转
+#define RANGE_NOISE_CM 0.3f  // 测距噪声标准差
+#define SPURIOUS_PERMILLE 10 // 虚假回波概率（千分比）
+#define MAX_LAG_MS 1000      // 滞后估计的最大搜索范围
+#define SPEED_LOG_SIZE (SIM_DURATION_MS / CONTROL_PERIOD_MS)
+
+// 车辆实际每cm/s所需PWM与 FOLLOW_PWM_PER_CM_S 之比（标定误差）
+static const float plant_gains[] = {0.8f, 1.25f};
+
+typedef enum { CTRL_LEGACY, CTRL_FEEDFORWARD } Controller;
+
+typedef struct {
+  const char *name;
+  float (*speed)(float t); // 前车速度 (cm/s)
+} Scenario;
+
+typedef struct {
+  float rms_error;
+  float max_error;
+  float lag_ms;
+  int max_step;
+  int collisions;
+  int lost;
+} Metrics;
+
+static uint32_t rng_state;
+
+static float Rand_Uniform(void) {
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return (rng_state >> 8) / 16777216.0f;
+}
+
+static float Rand_Gauss(void) {
+  float u1 = Rand_Uniform() + 1e-7f;
+  float u2 = Rand_Uniform();
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+// 前车速度脚本
+static float Leader_Constant(float t) { return (t < 1.0f) ? 0.0f : 40.0f; }
+
+static float Leader_Ramp(float t) {
+  if (t < 1.0f)
+    return 0.0f;
+  if (t < 9.0f)
+    return (t - 1.0f) * 10.0f;         // 8秒加速到80cm/s
+  float v = 80.0f - (t - 9.0f) * 8.0f; // 10秒减速到0
+  return (v > 0.0f) ? v : 0.0f;
+}
+
+// 每4秒一个周期：0.5秒加速到50cm/s，匀速2秒，0.5秒减速，停1秒
+static float Leader_Stop_Go(float t) {
+  if (t < 1.0f)
+    return 0.0f;
+  float phase = fmodf(t - 1.0f, 4.0f);
+  if (phase < 0.5f)
+    return phase * 100.0f;
+  if (phase < 2.5f)
+    return 50.0f;
+  if (phase < 3.0f)
+    return (3.0f - phase) * 100.0f;
+  return 0.0f;
+}
+
+static float Leader_Sine(float t) {
+  return (t < 1.0f) ? 0.0f : 40.0f + 30.0f * sinf(1.2f * (t - 1.0f));
+}
+
+static const Scenario scenarios[] = {
+    {"constant", Leader_Constant},
+    {"ramp", Leader_Ramp},
+    {"stop-go", Leader_Stop_Go},
+    {"sine", Leader_Sine},
+};
+
+// 原分段线性跟随（超声跟随避障.c中的Calculate_Follow_Speed）
+static int16_t Legacy_Follow_Speed(float d) {
+  if (d <= FOLLOW_STOP_DISTANCE || d > FOLLOW_MAX_DISTANCE)
+    return 0;
+  if (d > 6.0f) {
+    int16_t s = BASE_SPEED + (int16_t)((d - 6.0f) * SPEED_STEP);
+    return (s > MAX_SPEED) ? MAX_SPEED : s;
+  }
+  if (d >= 5.0f)
+    return BASE_SPEED;
+  int16_t s = BASE_SPEED - (int16_t)((5.0f - d) * SPEED_STEP);
+  return (s < MIN_SPEED) ? MIN_SPEED : s;
+}
+
+// 由前后两段速度序列的互相关估计跟随滞后
+static float Estimate_Lag(const float *leader, const float *follower, int n) {
+  int best_shift = 0;
+  float best_score = -1e30f;
+  for (int shift = 0; shift <= MAX_LAG_MS / CONTROL_PERIOD_MS; shift++) {
+    float score = 0.0f;
+    for (int i = 0; i + shift < n; i++) {
+      score -= fabsf(leader[i] - follower[i + shift]);
+    }
+    score /= (n - shift);
+    if (score > best_score) {
+      best_score = score;
+      best_shift = shift;
+    }
+  }
+  return best_shift * CONTROL_PERIOD_MS;
+}
+
+static Metrics Run(const Scenario *sc, Controller ctrl, float plant_gain,
+                   uint32_t seed) {
+  static float leader_log[SPEED_LOG_SIZE], follower_log[SPEED_LOG_SIZE];
+  Metrics m = {0};
+  Kalman_CV_Fixed kf, leader_kf;
+  Range_Validator rv;
+  Follow_Control fc;
+  Odometry odom;
+  float x_leader = FOLLOW_BASE_DISTANCE, x_self = 0.0f, v_self = 0.0f;
+  float filtered = RANGE_MAX_VALID_CM, err_sq = 0.0f, travel = 0.0f;
+  bool locked = false;
+  float travel_log[RANGE_MEDIAN_SIZE / 2 + 1] = {0}; // 与超声跟随避障.c相同
+  int travel_index = 0;
+  int16_t pwm = 0;
+  int samples = 0;
+
+  rng_state = seed;
+  Kalman_CV_Fixed_Init(&kf, RANGE_KF_Q, RANGE_KF_R, RANGE_KF_DT_MS);
+  Kalman_CV_Fixed_Init(&leader_kf, RANGE_KF_Q, RANGE_KF_R, RANGE_KF_DT_MS);
+  Range_Validator_Init(&rv);
+  Follow_Control_Init(&fc, FOLLOW_BASE_DISTANCE, 0, MAX_SPEED);
+  Odometry_Init(&odom, 0, 0);
+
+  for (uint32_t t = 0; t < SIM_DURATION_MS; t++) {
+    // 车辆动力学（1ms步长）
+    float v_leader = sc->speed(t * 0.001f);
+    float v_target = (pwm > MOTOR_DEADBAND || pwm < -MOTOR_DEADBAND)
+                         ? pwm / (FOLLOW_PWM_PER_CM_S * plant_gain)
+                         : 0.0f;
+    v_self += (v_target - v_self) * (0.001f / MOTOR_TAU_S);
+    x_leader += v_leader * 0.001f;
+    x_self += v_self * 0.001f;
+
+    if (t % CONTROL_PERIOD_MS != 0)
+      continue;
+
+    // 本车速度和累计距离：编码器计数经里程计差分（左右两侧相同）
+    int32_t count = (int32_t)floorf(x_self * ODOM_ENCODER_PER_CM);
+    Odometry_Update(&odom, count, count);
+    travel += odom.speed;
+    travel_log[travel_index] = travel;
+    travel_index = (travel_index + 1) % (RANGE_MEDIAN_SIZE / 2 + 1);
+    float self_speed = odom.speed * 1000.0f / CONTROL_PERIOD_MS;
+
+    // 测距：噪声 + 偶发虚假回波
+    float gap = x_leader - x_self;
+    float raw = gap + RANGE_NOISE_CM * Rand_Gauss();
+    if (Rand_Uniform() * 1000.0f < SPURIOUS_PERMILLE)
+      raw = 2.0f + Rand_Uniform() * 100.0f;
+
+    float valid;
+    switch (Range_Validator_Update(&rv, raw, t, &valid)) {
+    case RANGE_STATUS_OK:
+      filtered = Kalman_CV_Fixed_Update(&kf, valid, t);
+      Kalman_CV_Fixed_Update(&leader_kf, travel_log[travel_index] + valid, t);
+      break;
+    case RANGE_STATUS_NO_ECHO:
+      filtered = RANGE_MAX_VALID_CM;
+      break;
+    default:
+      break;
+    }
+
+    int16_t previous = pwm;
+    if (ctrl == CTRL_LEGACY) {
+      pwm = Legacy_Follow_Speed(filtered);
+    } else if (filtered <= FOLLOW_STOP_DISTANCE ||
+               filtered > (locked ? FOLLOW_LOST_DISTANCE
+                                  : FOLLOW_MAX_DISTANCE)) {
+      // 太近停车；超出跟随距离时原地找目标（仿真中没有侧面目标，即停车）
+      locked = false;
+      pwm = 0;
+      Follow_Control_Reset(&fc, 0);
+    } else {
+      locked = true;
+      float leader_speed = -Kalman_CV_Fixed_Closing_Speed(&leader_kf);
+      pwm = Follow_Control_Update(&fc, filtered, self_speed - leader_speed,
+                                  self_speed, CONTROL_PERIOD_MS);
+    }
+
+    // 统计
+    float error = gap - FOLLOW_BASE_DISTANCE;
+    err_sq += error * error;
+    if (fabsf(error) > m.max_error)
+      m.max_error = fabsf(error);
+    if (abs(pwm - previous) > m.max_step)
+      m.max_step = abs(pwm - previous);
+    if (gap <= 0.0f)
+      m.collisions++;
+    if (gap > FOLLOW_MAX_DISTANCE)
+      m.lost++;
+    leader_log[samples] = v_leader;
+    follower_log[samples] = v_self;
+    samples++;
+  }
+
+  m.rms_error = sqrtf(err_sq / samples);
+  m.lag_ms = Estimate_Lag(leader_log, follower_log, samples);
+  return m;
+}
+
+int main(int argc, char **argv) {
+  uint32_t seed = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1;
+  const char *names[] = {"legacy", "feedforward"};
+  bool pass = true;
+
+  printf("%-10s %5s %-12s %8s %8s %8s %8s %6s %6s\n", "scenario", "gain",
+         "controller", "rms(cm)", "max(cm)", "lag(ms)", "maxstep", "hit",
+         "lost");
+  for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    for (size_t g = 0; g < sizeof(plant_gains) / sizeof(plant_gains[0]); g++) {
+      for (int c = CTRL_LEGACY; c <= CTRL_FEEDFORWARD; c++) {
+        Metrics m = Run(&scenarios[i], (Controller)c, plant_gains[g], seed);
+        bool ok = c == CTRL_LEGACY || m.collisions == 0;
+        pass = pass && ok;
+        printf("%-10s %5.2f %-12s %8.2f %8.2f %8.0f %8d %6d %6d%s\n",
+               scenarios[i].name, plant_gains[g], names[c], m.rms_error,
+               m.max_error, m.lag_ms, m.max_step, m.collisions, m.lost,
+               ok ? "" : "  FAIL");
+      }
+    }
+  }
+  printf(pass ? "PASS\n" : "FAIL\n");
+  return pass ? 0 : 1;
+}
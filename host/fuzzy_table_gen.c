@@ -0,0 +1,118 @@
+// 避障模糊控制查找表生成器（主机程序）
+// 用法：gcc -I. -o fuzzy_table_gen host/fuzzy_table_gen.c -lm
+//       ./fuzzy_table_gen > fuzzy_table.c
+
+#include "fuzzy_control.h"
+#include <math.h>
+#include <stdio.h>
+
+#define LEVELS 3 // 每个输入三个语言值：0=远/无障碍 1=中/较近 2=近/很近
+#define OUTPUT_LIMIT 1000
+
+// 上升沿/下降沿线性隶属函数
+static double Ramp_Down(double x, double full, double zero) {
+  if (x <= full)
+    return 1.0;
+  if (x >= zero)
+    return 0.0;
+  return (zero - x) / (zero - full);
+}
+
+static double Ramp_Up(double x, double zero, double full) {
+  return 1.0 - Ramp_Down(x, zero, full);
+}
+
+// 距离隶属度，下标为严重程度
+static void Dist_Membership(double d, double mu[LEVELS]) {
+  mu[2] = Ramp_Down(d, FUZZY_DIST_NEAR_FULL, FUZZY_DIST_MID_PEAK);
+  mu[0] = Ramp_Up(d, FUZZY_DIST_MID_PEAK, FUZZY_DIST_FAR_FULL);
+  mu[1] = 1.0 - mu[0] - mu[2];
+}
+
+// IR隶属度（数值越小越近），下标为严重程度
+static void Ir_Membership(double ir, double mu[LEVELS]) {
+  mu[2] = Ramp_Down(ir, FUZZY_IR_CLOSE_FULL, FUZZY_IR_NEAR_PEAK);
+  mu[0] = Ramp_Up(ir, FUZZY_IR_NEAR_PEAK, FUZZY_IR_CLEAR_FULL);
+  mu[1] = 1.0 - mu[0] - mu[2];
+}
+
+// 规则后件：按三个输入的严重程度给出前进速度和转向量
+static void Rule_Output(int sd, int sl, int sr, double *v, double *w) {
+  int worst = sd;
+  if (sl > worst)
+    worst = sl;
+  if (sr > worst)
+    worst = sr;
+
+  if (sd == 2 || (sl == 2 && sr == 2)) {
+    *v = FUZZY_BACK_SPEED; // 正前方很近或两侧都很近：后退
+  } else if (worst == 2) {
+    *v = 0; // 单侧很近：原地转向
+  } else if (worst == 1) {
+    *v = FUZZY_SLOW_SPEED;
+  } else {
+    *v = FUZZY_FORWARD_SPEED;
+  }
+
+  // 右侧更近则左转（正值），左侧更近则右转
+  *w = (double)(sr - sl) * FUZZY_TURN_STEP;
+}
+
+static double Clamp(double x) {
+  if (x > OUTPUT_LIMIT)
+    return OUTPUT_LIMIT;
+  if (x < -OUTPUT_LIMIT)
+    return -OUTPUT_LIMIT;
+  return x;
+}
+
+int main(void) {
+  printf("// 自动生成文件，请勿手工修改\n");
+  printf("// 生成方式见 fuzzy_control.h\n\n");
+  printf("#include \"fuzzy_control.h\"\n\n");
+  printf("const int16_t Fuzzy_Avoid_Table[FUZZY_GRID_SIZE][FUZZY_GRID_SIZE]"
+         "\n                                [FUZZY_GRID_SIZE][2] = {\n");
+
+  for (int di = 0; di < FUZZY_GRID_SIZE; di++) {
+    double mu_d[LEVELS];
+    Dist_Membership(di * FUZZY_DIST_STEP, mu_d);
+    printf("    {\n");
+
+    for (int li = 0; li < FUZZY_GRID_SIZE; li++) {
+      double mu_l[LEVELS];
+      Ir_Membership(li * FUZZY_IR_STEP, mu_l);
+      printf("        {");
+
+      for (int ri = 0; ri < FUZZY_GRID_SIZE; ri++) {
+        double mu_r[LEVELS];
+        Ir_Membership(ri * FUZZY_IR_STEP, mu_r);
+
+        // 零阶Sugeno推理：乘积作为激活度，加权平均解模糊
+        double weight_sum = 0.0, v_sum = 0.0, w_sum = 0.0;
+        for (int sd = 0; sd < LEVELS; sd++) {
+          for (int sl = 0; sl < LEVELS; sl++) {
+            for (int sr = 0; sr < LEVELS; sr++) {
+              double weight = mu_d[sd] * mu_l[sl] * mu_r[sr];
+              double v, w;
+              if (weight <= 0.0)
+                continue;
+              Rule_Output(sd, sl, sr, &v, &w);
+              weight_sum += weight;
+              v_sum += weight * v;
+              w_sum += weight * w;
+            }
+          }
+        }
+
+        double v = v_sum / weight_sum;
+        double w = w_sum / weight_sum;
+        printf("{%ld, %ld}%s", lround(Clamp(v - w)), lround(Clamp(v + w)),
+               ri < FUZZY_GRID_SIZE - 1 ? ", " : "");
+      }
+      printf("},\n");
+    }
+    printf("    },\n");
+  }
+  printf("};\n");
+  return 0;
+}
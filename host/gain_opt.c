@@ -0,0 +1,345 @@
+// 巡线参数自动寻优：在全部内置赛道（多个随机种子）和录制的CCD日志上
+// 评估参数组合，多进程并行搜索，按综合代价排序输出；结果可直接用 param_tool load 写入小车
+// 用法：gcc -O2 -Ihost -I. -o gain_opt host/gain_opt.c host/track_sim.c
+//           host/bsp_host.c param_table.c ccd_process.c line_tracking.c
+//           motor_output.c odometry.c -lm
+//       ./gain_opt [-j 进程数] [-g 代数] [-p 每代个数] [-s 种子数]
+//                  [-k 输出个数] [-r 随机种子] [CCD日志...] > best.txt
+//       ./param_tool <串口> load best.txt
+// 搜索范围见 search_space；日志格式见 track_sim.h 中的 Sim_Log
+
+#include "mode_manager.h"
+#include "param_table.h"
+#include "track_sim.h"
+#include <math.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// 代价权重：圈速（秒）为主，误差、丢线和转向抖动折算成秒
+#define OPT_DNF_PENALTY_S 60.0f // 未完成时在超时时间上再按未完成比例加罚
+#define OPT_WEIGHT_RMS 2.0f     // 每cm均方根横向误差
+#define OPT_WEIGHT_LOST 0.2f    // 每1%丢线帧
+#define OPT_WEIGHT_JITTER 0.01f // 回放中每单位PWM转向抖动
+#define OPT_MIN_TARGET_GAP 20   // 曝光目标上下限的最小间隔
+
+#define OPT_MAX_DIM 8
+#define OPT_MAX_LOGS 16
+#define OPT_MAX_JOBS 64
+
+// 搜索范围（名称即参数表中的名称，不在表中的参数保持默认值）
+typedef struct {
+  const char *name;
+  float lo, hi;
+} Opt_Dim;
+
+static const Opt_Dim search_space[] = {
+    {"trk.kp", 4, 30},      {"trk.ki", 0, 1},       {"trk.kd", 0, 30},
+    {"trk.slow", 0, 1},     {"trk.diff", 100, 600}, {"ccd.tmax", 80, 250},
+    {"ccd.tmin", 10, 120},
+};
+
+#define OPT_DIM (int)(sizeof(search_space) / sizeof(search_space[0]))
+
+typedef struct {
+  float value[OPT_MAX_DIM];
+  float cost;
+  float lap_s;  // 已完成各圈的平均圈速
+  int finished; // 完成圈数
+  float rms;    // 平均均方根横向误差 (cm)
+  float lost;   // 丢线帧比例（仿真和回放合计，%）
+  float jitter; // 回放转向抖动（无日志时为0）
+} Opt_Candidate;
+
+// 跟随避障模式不参与寻优，这里只为参数表提供存储
+Follow_Avoid_Config follow_avoid_config;
+
+static Sim_Course courses[16];
+static int course_count;
+static Sim_Log logs[OPT_MAX_LOGS];
+static int log_count;
+static int seeds = 2;
+static uint8_t dim_id[OPT_MAX_DIM];
+static uint32_t rng_state = 1;
+
+static float Rand_Uniform(void) {
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return (rng_state >> 8) / 16777216.0f;
+}
+
+static float Rand_Gauss(void) {
+  float u1 = Rand_Uniform() + 1e-7f;
+  float u2 = Rand_Uniform();
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+static float Clamp(float value, float lo, float hi) {
+  return (value < lo) ? lo : (value > hi) ? hi : value;
+}
+
+// 修正无效组合：曝光目标上限必须明显高于下限
+static void Repair(Opt_Candidate *c) {
+  for (int d = 0; d < OPT_DIM; d++) {
+    c->value[d] = Clamp(c->value[d], search_space[d].lo, search_space[d].hi);
+  }
+  for (int d = 0; d < OPT_DIM; d++) {
+    if (strcmp(search_space[d].name, "ccd.tmin") != 0)
+      continue;
+    for (int m = 0; m < OPT_DIM; m++) {
+      if (strcmp(search_space[m].name, "ccd.tmax") == 0 &&
+          c->value[d] > c->value[m] - OPT_MIN_TARGET_GAP)
+        c->value[d] = c->value[m] - OPT_MIN_TARGET_GAP;
+    }
+  }
+}
+
+// 在子进程中评估一组参数（各子进程拥有独立的全局状态）
+static void Evaluate(Opt_Candidate *c) {
+  float lap_sum = 0.0f, rms_sum = 0.0f, penalty = 0.0f, jitter = 0.0f;
+  uint32_t frames = 0, lost = 0;
+  int runs = 0;
+
+  Param_Load_Defaults();
+  for (int d = 0; d < OPT_DIM; d++) {
+    Param_Set(dim_id[d], c->value[d]);
+    c->value[d] = Param_Get(dim_id[d]); // 整数参数按实际写入值记录
+  }
+
+  c->finished = 0;
+  for (int k = 0; k < course_count; k++) {
+    for (int s = 1; s <= seeds; s++) {
+      Sim_Result r = Sim_Run(&courses[k], (uint32_t)s, NULL);
+      runs++;
+      rms_sum += r.rms_error;
+      frames += r.frames;
+      lost += r.lost_frames;
+      if (r.outcome == SIM_FINISHED) {
+        lap_sum += r.lap_ms / 1000.0f;
+        c->finished++;
+      } else {
+        penalty += SIM_TIMEOUT_MS / 1000.0f +
+                   OPT_DNF_PENALTY_S * (1.0f - r.distance / courses[k].length);
+      }
+    }
+  }
+
+  for (int k = 0; k < log_count; k++) {
+    Sim_Replay_Result r = Sim_Replay(&logs[k], NULL);
+    frames += r.frames;
+    lost += r.lost_frames;
+    jitter += r.steer_jitter / log_count;
+  }
+
+  c->lap_s = c->finished ? lap_sum / c->finished : 0.0f;
+  c->rms = rms_sum / runs;
+  c->lost = frames ? 100.0f * lost / frames : 0.0f;
+  c->jitter = jitter;
+  c->cost = (lap_sum + penalty) / runs + OPT_WEIGHT_RMS * c->rms +
+            OPT_WEIGHT_LOST * c->lost + OPT_WEIGHT_JITTER * c->jitter;
+}
+
+// 把一批候选分给jobs个子进程并行评估，结果经管道传回
+static bool Evaluate_Batch(Opt_Candidate *batch, int count, int jobs) {
+  int fds[OPT_MAX_JOBS];
+  pid_t pids[OPT_MAX_JOBS];
+
+  if (jobs > count)
+    jobs = count;
+  for (int w = 0; w < jobs; w++) {
+    int pipe_fd[2];
+    if (pipe(pipe_fd) != 0)
+      return false;
+    fflush(NULL);
+    pids[w] = fork();
+    if (pids[w] < 0)
+      return false;
+    if (pids[w] == 0) {
+      close(pipe_fd[0]);
+      for (int i = w; i < count; i += jobs) {
+        Evaluate(&batch[i]);
+        if (write(pipe_fd[1], &i, sizeof(i)) != sizeof(i) ||
+            write(pipe_fd[1], &batch[i], sizeof(batch[i])) != sizeof(batch[i]))
+          _exit(1);
+      }
+      _exit(0);
+    }
+    close(pipe_fd[1]);
+    fds[w] = pipe_fd[0];
+  }
+
+  bool ok = true;
+  for (int w = 0; w < jobs; w++) {
+    FILE *in = fdopen(fds[w], "rb");
+    int i;
+    while (fread(&i, sizeof(i), 1, in) == 1) {
+      if (i < 0 || i >= count ||
+          fread(&batch[i], sizeof(batch[i]), 1, in) != 1)
+        ok = false;
+    }
+    fclose(in);
+    int status;
+    waitpid(pids[w], &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      ok = false;
+  }
+  return ok;
+}
+
+static int Compare_Cost(const void *a, const void *b) {
+  float ca = ((const Opt_Candidate *)a)->cost;
+  float cb = ((const Opt_Candidate *)b)->cost;
+  return (ca > cb) - (ca < cb);
+}
+
+static void Print_Ranking(const Opt_Candidate *ranked, int count, int top) {
+  printf("# %4s %8s %7s %7s %7s %6s %6s", "rank", "cost", "lap(s)", "finish",
+         "rms(cm)", "lost%", "jitter");
+  for (int d = 0; d < OPT_DIM; d++) {
+    printf(" %8s", search_space[d].name);
+  }
+  printf("\n");
+  for (int i = 0; i < top && i < count; i++) {
+    const Opt_Candidate *c = &ranked[i];
+    printf("# %4d %8.2f %7.2f %3d/%-3d %7.2f %6.1f %6.1f", i + 1, c->cost,
+           c->lap_s, c->finished, course_count * seeds, c->rms, c->lost,
+           c->jitter);
+    for (int d = 0; d < OPT_DIM; d++) {
+      printf(" %8.3g", c->value[d]);
+    }
+    printf("\n");
+  }
+}
+
+int main(int argc, char **argv) {
+  int jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int generations = 8, population = 24, top = 5;
+
+  for (int i = 1; i < argc; i++) {
+    if (argv[i][0] == '-' && argv[i][1] != '\0' && i + 1 < argc) {
+      int value = atoi(argv[i + 1]);
+      switch (argv[i][1]) {
+      case 'j':
+        jobs = value;
+        break;
+      case 'g':
+        generations = value;
+        break;
+      case 'p':
+        population = value;
+        break;
+      case 's':
+        seeds = value;
+        break;
+      case 'k':
+        top = value;
+        break;
+      case 'r':
+        rng_state = (uint32_t)value;
+        break;
+      default:
+        fprintf(stderr, "unknown option %s\n", argv[i]);
+        return 2;
+      }
+      i++;
+    } else if (log_count < OPT_MAX_LOGS) {
+      if (!Sim_Log_Load(&logs[log_count], argv[i])) {
+        fprintf(stderr, "%s: no frames\n", argv[i]);
+        return 2;
+      }
+      log_count++;
+    }
+  }
+  jobs = (int)Clamp(jobs, 1, OPT_MAX_JOBS);
+  if (population < 4 || generations < 1 || seeds < 1) {
+    fprintf(stderr, "population must be >= 4, generations and seeds >= 1\n");
+    return 2;
+  }
+
+  // 查找参数编号，记录默认值作为第一个候选
+  Param_Table_Init();
+  Opt_Candidate start = {.cost = 0};
+  for (int d = 0; d < OPT_DIM; d++) {
+    int id;
+    for (id = 0; id < Param_Count(); id++) {
+      if (strcmp(Param_Get_Desc(id)->name, search_space[d].name) == 0)
+        break;
+    }
+    if (id == Param_Count()) {
+      fprintf(stderr, "%s: not in parameter table\n", search_space[d].name);
+      return 2;
+    }
+    dim_id[d] = id;
+    start.value[d] = Param_Get(id);
+  }
+
+  for (int k = 0; k < Sim_Track_Count && k < 16; k++) {
+    if (!Sim_Course_Build(&courses[course_count++], &Sim_Tracks[k])) {
+      fprintf(stderr, "%s: out of memory\n", Sim_Tracks[k].name);
+      return 2;
+    }
+  }
+
+  // 第0代：默认值 + 均匀随机；之后每代保留前1/4，按逐代缩小的步长高斯变异
+  int total = population * generations;
+  Opt_Candidate *archive = malloc(total * sizeof(Opt_Candidate));
+  if (archive == NULL)
+    return 2;
+  int evaluated = 0;
+  float sigma = 0.2f;
+
+  for (int g = 0; g < generations; g++) {
+    Opt_Candidate *batch = &archive[evaluated];
+    int elite = population / 4;
+    for (int i = 0; i < population; i++) {
+      if (g == 0) {
+        batch[i] = start;
+        for (int d = 0; i > 0 && d < OPT_DIM; d++) {
+          batch[i].value[d] =
+              search_space[d].lo +
+              Rand_Uniform() * (search_space[d].hi - search_space[d].lo);
+        }
+      } else {
+        batch[i] = archive[(int)(Rand_Uniform() * elite) % elite];
+        for (int d = 0; d < OPT_DIM; d++) {
+          batch[i].value[d] += sigma * Rand_Gauss() *
+                               (search_space[d].hi - search_space[d].lo);
+        }
+      }
+      Repair(&batch[i]);
+    }
+    if (!Evaluate_Batch(batch, population, jobs)) {
+      fprintf(stderr, "worker failed\n");
+      return 1;
+    }
+    evaluated += population;
+    if (g > 0)
+      sigma *= 0.7f;
+
+    // 历史结果整体排序，前elite个即为下一代的父代
+    qsort(archive, evaluated, sizeof(Opt_Candidate), Compare_Cost);
+    fprintf(stderr,
+            "generation %d: best cost %.2f, lap %.2f s, %d/%d finished\n", g,
+            archive[0].cost, archive[0].lap_s, archive[0].finished,
+            course_count * seeds);
+  }
+
+  Evaluate_Batch(&start, 1, 1);
+  printf("# gain_opt: %d tracks x %d seeds, %d CCD logs, %d evaluations\n",
+         course_count, seeds, log_count, evaluated);
+  printf("# defaults: cost %.2f, lap %.2f s, %d/%d finished\n", start.cost,
+         start.lap_s, start.finished, course_count * seeds);
+  Print_Ranking(archive, evaluated, top);
+  printf("# rank 1, load with: param_tool <port> load <file>\n");
+  for (int d = 0; d < OPT_DIM; d++) {
+    printf("%s %g\n", search_space[d].name, archive[0].value[d]);
+  }
+
+  for (int k = 0; k < course_count; k++) {
+    Sim_Course_Free(&courses[k]);
+  }
+  for (int k = 0; k < log_count; k++) {
+    Sim_Log_Free(&logs[k]);
+  }
+  free(archive);
+  return 0;
+}
@@ -0,0 +1,161 @@
+// 电机输出检查：按定长直行、直角弯和巡线的调用方式驱动 motor_output.c，
+// 在主机替身记录的命令时间线上检查每路的变化率限制（加速和反向时的减速）、
+// 四路是否批量写入，以及只设置一次的目标最终能否到达
+// 用法：gcc -O2 -Ihost -I. -o motor_check host/motor_check.c
+//           host/bsp_host.c motor_output.c
+//       ./motor_check [seed]
+// 全部检查通过时输出 PASS 并返回0；失败时输出第一处错误并返回1
+
+#include "bsp.h"
+#include "motor_output.h"
+#include <stdlib.h>
+
+#define HOLD_MS 200 // 每个场景最后保持目标不变的时间，应足以到达目标
+
+static int16_t target[4];
+static const char *scenario;
+
+// 各次设置的时刻和目标，用于判断某条命令发生时是否处于反向过程
+#define GOAL_LOG_SIZE 4096
+static struct {
+  uint32_t tick;
+  int16_t pwm[4];
+} goal_log[GOAL_LOG_SIZE];
+static uint32_t goal_count = 0;
+static bool pass = true;
+
+static void Fail(const char *what, uint32_t tick) {
+  if (pass)
+    printf("%s: %s at %u ms\n", scenario, what, tick);
+  pass = false;
+}
+
+static void Set_LR(int16_t left, int16_t right) {
+  target[0] = target[1] = left;
+  target[2] = target[3] = right;
+  if (goal_count < GOAL_LOG_SIZE) {
+    goal_log[goal_count].tick = HAL_GetTick();
+    memcpy(goal_log[goal_count].pwm, target, sizeof(target));
+    goal_count++;
+  }
+  Motor_Output_Set_LR(left, right);
+}
+
+// tick时刻生效的目标（该时刻之前最后一次设置的目标）
+static const int16_t *Goal_At(uint32_t tick) {
+  static const int16_t zero[4] = {0};
+  const int16_t *goal = zero;
+  for (uint32_t k = 0; k < goal_count && goal_log[k].tick <= tick; k++)
+    goal = goal_log[k].pwm;
+  return goal;
+}
+
+// 主循环：每ms一个周期，stall为true时跳过周期（模拟主循环卡顿）
+static void Run(uint32_t ms, bool stall) {
+  for (uint32_t i = 0; i < ms; i++) {
+    Host_Advance_Tick(1);
+    if (stall && rand() % 50 == 0)
+      Host_Advance_Tick(1 + rand() % 30);
+    Motor_Output_Tick();
+  }
+}
+
+// 远离0的变化量（反向时按从0算起）
+static int32_t Away_From_Zero(int16_t before, int16_t after) {
+  if ((before > 0 && after < 0) || (before < 0 && after > 0))
+    return ABS(after);
+  return ABS(after) - ABS(before);
+}
+
+// 反向过程中的一次更新：减速段同样限速，且不能一步越过0
+static bool Reverse_Too_Fast(int16_t before, int16_t after, int16_t goal,
+                             uint32_t dt) {
+  bool reversing = (before > 0 && goal < 0) || (before < 0 && goal > 0);
+  if (!reversing)
+    return false;
+  if ((before > 0 && after < 0) || (before < 0 && after > 0))
+    return true;
+  return ABS(before) - ABS(after) > (int32_t)(MOTOR_REVERSE_SLEW_PER_MS * dt);
+}
+
+// 检查时间线并确认保持一段时间后到达目标
+static void Check(void) {
+  uint32_t count;
+  const Host_Motor_Event *timeline = Host_Motor_Timeline(&count);
+  int16_t previous[4] = {0};
+  uint32_t previous_tick = (count > 0) ? timeline[0].tick : 0;
+
+  for (uint32_t k = 0; k < count; k++) {
+    const Host_Motor_Event *e = &timeline[k];
+    const int16_t *goal = Goal_At(e->tick);
+    if (e->split)
+      Fail("four channels written across an update event", e->tick);
+    uint32_t dt = e->tick - previous_tick;
+    for (int i = 0; i < 4; i++) {
+      if (Away_From_Zero(previous[i], e->pwm[i]) >
+          (int32_t)(MOTOR_SLEW_PER_MS * dt))
+        Fail("slew limit exceeded", e->tick);
+      if (Reverse_Too_Fast(previous[i], e->pwm[i], goal[i], dt))
+        Fail("reversal not rate limited", e->tick);
+    }
+    memcpy(previous, e->pwm, sizeof(previous));
+    previous_tick = e->tick;
+  }
+
+  const int16_t *pwm = Host_Motor_Pwm();
+  for (int i = 0; i < 4; i++) {
+    if (pwm[i] != target[i])
+      Fail("target not reached", HAL_GetTick());
+  }
+  printf("%-10s %6u events%s\n", scenario, count, pass ? "" : "  FAIL");
+}
+
+static void Begin(const char *name, uint32_t start_tick) {
+  scenario = name;
+  Host_Set_Tick(start_tick);
+  Host_Motor_Timeline_Clear();
+  Motor_Output_Init();
+  memset(target, 0, sizeof(target));
+  goal_count = 0;
+}
+
+int main(int argc, char **argv) {
+  uint32_t seed = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1;
+  srand(seed);
+
+  // 定长直行：开机很久后按键起步，只设置一次
+  Begin("start", 60000);
+  Set_LR(800, 800);
+  Run(HOLD_MS, false);
+  Check();
+
+  // 直角弯：起步后不到40ms按键反转，同样只设置一次
+  Begin("reverse", 1000);
+  Set_LR(1000, -1000);
+  Run(20, false);
+  Set_LR(-1000, 1000);
+  Run(HOLD_MS, false);
+  Check();
+
+  // 减速和停车立即生效
+  Begin("brake", 0);
+  Set_LR(600, 600);
+  Run(HOLD_MS, false);
+  Set_LR(200, 0);
+  if (Host_Motor_Pwm()[0] != 200 || Host_Motor_Pwm()[2] != 0)
+    Fail("slow-down delayed", HAL_GetTick());
+  Run(HOLD_MS, false);
+  Check();
+
+  // 巡线：每个周期给出随机目标，主机循环偶尔卡顿
+  Begin("random", 0);
+  for (int k = 0; k < 2000; k++) {
+    Set_LR(rand() % 2001 - 1000, rand() % 2001 - 1000);
+    Run(1 + rand() % 10, true);
+  }
+  Run(HOLD_MS, false);
+  Check();
+
+  printf(pass ? "PASS\n" : "FAIL\n");
+  return pass ? 0 : 1;
+}
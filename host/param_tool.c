@@ -0,0 +1,358 @@
+// 串口调参上位机：按 param_link.h 中的协议读写小车上的运行时参数
+// 用法：gcc -O2 -I. -o param_tool host/param_tool.c
+//       ./param_tool <串口> [-b 波特率] <命令> [参数...]
+// 命令：list                    列出全部参数（编号、名称、类型、范围、当前值）
+//       get <名称>...           读取参数
+//       set <名称> <值>...      写入参数（立即生效，未写入Flash）
+//       load <文件>             按文件写入参数，每行"名称 值"或"名称=值"，#开头为注释
+//       snapshot | revert | defaults | commit
+//       blackbox [文件]         读出黑匣子记录，输出CSV（默认到标准输出）
+//       arm                     清空黑匣子并重新开始记录
+
+#include "black_box.h"
+#include "param_link.h"
+#include "param_table.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define TOOL_TIMEOUT_MS 300
+#define TOOL_RETRIES 3
+#define TOOL_MAX_PARAMS 255
+
+typedef struct {
+  char name[PARAM_LINK_MAX_PAYLOAD + 1];
+  uint8_t type;
+  float min, max;
+} Tool_Param;
+
+static int port = -1;
+static Tool_Param params[TOOL_MAX_PARAMS];
+static int param_count = -1;
+
+static const char *type_names[] = {"i16", "u16", "u8", "f32"};
+static const char *status_names[] = {"ok",   "bad id", "out of range",
+                                     "busy", "flash",  "bad command"};
+
+static uint8_t Crc8(uint8_t crc, const uint8_t *data, int len) {
+  while (len--) {
+    crc ^= *data++;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static speed_t Baud_Constant(long baud) {
+  switch (baud) {
+  case 9600:
+    return B9600;
+  case 57600:
+    return B57600;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  default:
+    return B115200;
+  }
+}
+
+static int Open_Port(const char *path, long baud) {
+  struct termios tio;
+  int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0 || tcgetattr(fd, &tio) != 0)
+    return -1;
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, Baud_Constant(baud));
+  cfsetospeed(&tio, Baud_Constant(baud));
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &tio);
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+static int Read_Byte(int timeout_ms) {
+  struct pollfd pfd = {port, POLLIN, 0};
+  uint8_t byte;
+  if (poll(&pfd, 1, timeout_ms) <= 0 || read(port, &byte, 1) != 1)
+    return -1;
+  return byte;
+}
+
+// 发送请求并等待对应的应答，跳过printf文本和校验错误的帧；返回应答payload长度
+static int Transact(uint8_t cmd, const uint8_t *payload, int len,
+                    uint8_t *reply) {
+  uint8_t frame[PARAM_LINK_MAX_PAYLOAD + 4];
+  frame[0] = PARAM_LINK_SYNC;
+  frame[1] = cmd;
+  frame[2] = len;
+  memcpy(&frame[3], payload, len);
+  frame[3 + len] = Crc8(0, &frame[1], len + 2);
+
+  for (int attempt = 0; attempt < TOOL_RETRIES; attempt++) {
+    if (write(port, frame, len + 4) != len + 4)
+      return -1;
+
+    int byte;
+    while ((byte = Read_Byte(TOOL_TIMEOUT_MS)) >= 0) {
+      if (byte != PARAM_LINK_SYNC)
+        continue;
+      uint8_t header[2];
+      int c = Read_Byte(TOOL_TIMEOUT_MS), n = Read_Byte(TOOL_TIMEOUT_MS);
+      if (c < 0 || n < 0 || n > PARAM_LINK_MAX_PAYLOAD)
+        break;
+      header[0] = c;
+      header[1] = n;
+      int i;
+      for (i = 0; i < n; i++) {
+        int b = Read_Byte(TOOL_TIMEOUT_MS);
+        if (b < 0)
+          break;
+        reply[i] = b;
+      }
+      int crc = Read_Byte(TOOL_TIMEOUT_MS);
+      if (i == n && crc == Crc8(Crc8(0, header, 2), reply, n) &&
+          c == (cmd | PARAM_LINK_REPLY))
+        return n;
+    }
+  }
+  return -1;
+}
+
+static float Get_Float(const uint8_t *src) {
+  float value;
+  memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+// 读取参数表描述
+static int Load_Table(void) {
+  uint8_t reply[PARAM_LINK_MAX_PAYLOAD];
+  if (param_count >= 0)
+    return param_count;
+  if (Transact(PARAM_CMD_COUNT, NULL, 0, reply) != 1)
+    return -1;
+
+  int count = reply[0];
+  for (int id = 0; id < count; id++) {
+    uint8_t request = id;
+    int n = Transact(PARAM_CMD_DESCRIBE, &request, 1, reply);
+    if (n < 10)
+      return -1;
+    params[id].type = reply[1];
+    params[id].min = Get_Float(&reply[2]);
+    params[id].max = Get_Float(&reply[6]);
+    memcpy(params[id].name, &reply[10], n - 10);
+    params[id].name[n - 10] = '\0';
+  }
+  param_count = count;
+  return count;
+}
+
+static int Find_Param(const char *name) {
+  if (Load_Table() < 0)
+    return -1;
+  for (int id = 0; id < param_count; id++) {
+    if (strcmp(params[id].name, name) == 0)
+      return id;
+  }
+  return -1;
+}
+
+static const char *Status_Name(uint8_t status) {
+  return (status < sizeof(status_names) / sizeof(status_names[0]))
+             ? status_names[status]
+             : "?";
+}
+
+// 读或写一个参数，打印结果；返回0表示成功
+static int Access_Param(const char *name, const char *value) {
+  uint8_t request[5], reply[PARAM_LINK_MAX_PAYLOAD];
+  int id = Find_Param(name);
+  if (id < 0) {
+    fprintf(stderr, "%s: unknown parameter\n", name);
+    return 1;
+  }
+
+  request[0] = id;
+  int n;
+  if (value != NULL) {
+    float v = strtof(value, NULL);
+    memcpy(&request[1], &v, sizeof(v));
+    n = Transact(PARAM_CMD_SET, request, 5, reply);
+  } else {
+    n = Transact(PARAM_CMD_GET, request, 1, reply);
+  }
+  if (n != 6) {
+    fprintf(stderr, "%s: no reply\n", name);
+    return 1;
+  }
+  printf("%-10s %g", name, Get_Float(&reply[2]));
+  if (reply[1] != PARAM_OK)
+    printf("  (%s, range %g..%g)", Status_Name(reply[1]), params[id].min,
+           params[id].max);
+  printf("\n");
+  return reply[1] != PARAM_OK;
+}
+
+static int Load_File(const char *path) {
+  char line[128];
+  int errors = 0;
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    perror(path);
+    return 1;
+  }
+  while (fgets(line, sizeof(line), file) != NULL) {
+    char name[64], value[32];
+    char *eq = strchr(line, '=');
+    if (eq != NULL)
+      *eq = ' ';
+    if (line[0] == '#' || sscanf(line, "%63s %31s", name, value) != 2)
+      continue;
+    errors += Access_Param(name, value);
+  }
+  fclose(file);
+  return errors;
+}
+
+static int Simple_Command(uint8_t cmd) {
+  uint8_t reply[PARAM_LINK_MAX_PAYLOAD];
+  if (Transact(cmd, NULL, 0, reply) != 1) {
+    fprintf(stderr, "no reply\n");
+    return 1;
+  }
+  printf("%s\n", Status_Name(reply[0]));
+  return reply[0] != PARAM_OK;
+}
+
+static const char *Trigger_Name(uint8_t trigger) {
+  static const char *names[] = {"armed", "line lost", "key", "overrun"};
+  return (trigger < 4) ? names[trigger] : "?";
+}
+
+// 读出黑匣子：先读表头，再逐条读取记录；编码器计数和时刻按16位回绕展开
+static int Dump_Black_Box(const char *path) {
+  uint8_t reply[PARAM_LINK_MAX_PAYLOAD];
+  if (Transact(PARAM_CMD_BOX_INFO, NULL, 0, reply) != 10 ||
+      reply[0] != PARAM_OK) {
+    fprintf(stderr, "no reply\n");
+    return 1;
+  }
+  uint8_t trigger = reply[1];
+  uint16_t count, trigger_index;
+  uint32_t trigger_tick;
+  memcpy(&count, &reply[2], 2);
+  memcpy(&trigger_index, &reply[4], 2);
+  memcpy(&trigger_tick, &reply[6], 4);
+
+  FILE *out = stdout;
+  if (path != NULL && (out = fopen(path, "w")) == NULL) {
+    perror(path);
+    return 1;
+  }
+  fprintf(out, "# trigger %s at %u ms, record %u of %u\n",
+          Trigger_Name(trigger), trigger_tick, trigger_index, count);
+  fprintf(out, "index,time_ms,mode,stage,median,width,exposure,loop_ms,"
+               "left,right,m1,m2,m3,m4\n");
+
+  int errors = 0;
+  long time = 0, left = 0, right = 0;
+  Black_Box_Record last = {0};
+  for (uint16_t i = 0; i < count; i++) {
+    uint8_t request[2] = {i & 0xFF, i >> 8};
+    Black_Box_Record r;
+    if (Transact(PARAM_CMD_BOX_READ, request, 2, reply) !=
+            3 + (int)sizeof(r) ||
+        reply[2] != PARAM_OK) {
+      fprintf(stderr, "record %u: no reply\n", i);
+      errors++;
+      continue;
+    }
+    memcpy(&r, &reply[3], sizeof(r));
+    if (i == 0) {
+      left = r.count[0];
+      right = r.count[1];
+    } else {
+      time += (uint16_t)(r.tick - last.tick);
+      left += (int16_t)(r.count[0] - last.count[0]);
+      right += (int16_t)(r.count[1] - last.count[1]);
+    }
+    last = r;
+    fprintf(out, "%u,%ld,%u,%u,%u,%u,%u,%u,%ld,%ld,%d,%d,%d,%d\n", i, time,
+            r.mode, r.stage, r.median, r.width, r.exposure, r.loop_ms, left,
+            right, r.pwm[0], r.pwm[1], r.pwm[2], r.pwm[3]);
+  }
+  if (out != stdout)
+    fclose(out);
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  long baud = 115200;
+  int arg = 2;
+
+  if (argc >= 4 && strcmp(argv[2], "-b") == 0) {
+    baud = strtol(argv[3], NULL, 0);
+    arg = 4;
+  }
+  if (argc <= arg) {
+    fprintf(stderr, "usage: %s <port> [-b baud] list|get|set|load|snapshot|"
+                    "revert|defaults|commit|blackbox|arm ...\n",
+            argv[0]);
+    return 2;
+  }
+  port = Open_Port(argv[1], baud);
+  if (port < 0) {
+    perror(argv[1]);
+    return 2;
+  }
+
+  const char *cmd = argv[arg++];
+  int errors = 0;
+  if (strcmp(cmd, "list") == 0) {
+    if (Load_Table() < 0) {
+      fprintf(stderr, "no reply\n");
+      return 1;
+    }
+    for (int id = 0; id < param_count; id++) {
+      printf("%3d %-4s [%g, %g]\t", id, type_names[params[id].type & 3],
+             params[id].min, params[id].max);
+      fflush(stdout);
+      errors += Access_Param(params[id].name, NULL);
+    }
+  } else if (strcmp(cmd, "get") == 0) {
+    for (; arg < argc; arg++)
+      errors += Access_Param(argv[arg], NULL);
+  } else if (strcmp(cmd, "set") == 0) {
+    for (; arg + 1 < argc; arg += 2)
+      errors += Access_Param(argv[arg], argv[arg + 1]);
+  } else if (strcmp(cmd, "load") == 0 && arg < argc) {
+    errors = Load_File(argv[arg]);
+  } else if (strcmp(cmd, "snapshot") == 0) {
+    errors = Simple_Command(PARAM_CMD_SNAPSHOT);
+  } else if (strcmp(cmd, "revert") == 0) {
+    errors = Simple_Command(PARAM_CMD_REVERT);
+  } else if (strcmp(cmd, "defaults") == 0) {
+    errors = Simple_Command(PARAM_CMD_DEFAULTS);
+  } else if (strcmp(cmd, "commit") == 0) {
+    errors = Simple_Command(PARAM_CMD_COMMIT);
+  } else if (strcmp(cmd, "blackbox") == 0) {
+    errors = Dump_Black_Box((arg < argc) ? argv[arg] : NULL);
+  } else if (strcmp(cmd, "arm") == 0) {
+    errors = Simple_Command(PARAM_CMD_BOX_ARM);
+  } else {
+    fprintf(stderr, "unknown command: %s\n", cmd);
+    errors = 1;
+  }
+
+  close(port);
+  return errors != 0;
+}
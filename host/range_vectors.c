@@ -0,0 +1,155 @@
+// 超声测距检验的回放向量：把虚假回波、超时、无回波和真实跳变的读数序列
+// 依次送入 range_validator.c，逐条核对返回状态和输出距离，
+// 每个序列结束后核对诊断计数器
+// 用法：gcc -O2 -I. -o range_vectors host/range_vectors.c range_validator.c
+//           -lm
+//       ./range_vectors
+// 全部一致时输出 PASS 并返回0；否则输出不一致的条目并返回1
+
+#include "range_validator.h"
+#include <math.h>
+#include <stdio.h>
+
+#define NO_OUTPUT -1.0f // 非OK状态不写输出
+
+typedef struct {
+  uint32_t t;          // 采样时刻 (ms)
+  float raw;           // 原始读数 (cm)
+  Range_Status status; // 期望状态
+  float output;        // 期望输出，非OK时为NO_OUTPUT
+} Range_Vector;
+
+typedef struct {
+  const char *name;
+  const Range_Vector *vectors;
+  int count;
+  Range_Counters counters; // 序列结束后的期望计数
+} Range_Sequence;
+
+#define OK RANGE_STATUS_OK
+#define TIMEOUT RANGE_STATUS_TIMEOUT
+#define NO_ECHO RANGE_STATUS_NO_ECHO
+#define OUTLIER RANGE_STATUS_OUTLIER
+
+// 窗口填满后的单个和两个连续虚假回波被中值挡住，输出保持不变
+static const Range_Vector spurious[] = {
+    {0, 100, OK, 100},   {60, 100, OK, 100},  {120, 100, OK, 100},
+    {180, 100, OK, 100}, {240, 100, OK, 100}, {300, 30, OK, 100},
+    {360, 100, OK, 100}, {420, 100, OK, 100}, {480, 250, OK, 100},
+    {540, 100, OK, 100}, {600, 30, OK, 100},  {660, 30, OK, 100},
+    {720, 100, OK, 100},
+};
+
+// 窗口未填满时虚假回波成为中值，由变化率门限剔除
+static const Range_Vector early[] = {
+    {0, 100, OK, 100},
+    {60, 300, OUTLIER, NO_OUTPUT},
+    {120, 100, OK, 100},
+    {180, 100, OK, 100},
+};
+
+// 超时和无回波不进入窗口，也不改变门限基准；400cm本身仍有效
+static const Range_Vector timeout[] = {
+    {0, 100, OK, 100},
+    {60, 0, TIMEOUT, NO_OUTPUT},
+    {120, 0.4f, TIMEOUT, NO_OUTPUT},
+    {180, 450, NO_ECHO, NO_OUTPUT},
+    {240, 400.5f, NO_ECHO, NO_OUTPUT},
+    {300, 100, OK, 100},
+    {360, 400, OK, 100},
+    {420, 102, OK, 102},
+};
+
+// 真实跳变（100到40cm）：中值翻转后被门限拦住，门限随时间放宽后接受
+static const Range_Vector step[] = {
+    {0, 100, OK, 100},
+    {60, 100, OK, 100},
+    {120, 100, OK, 100},
+    {180, 100, OK, 100},
+    {240, 100, OK, 100},
+    {300, 40, OK, 100},
+    {360, 40, OK, 100},
+    {420, 40, OUTLIER, NO_OUTPUT}, // 门限 300*0.06+2=20
+    {480, 40, OUTLIER, NO_OUTPUT}, // 38
+    {540, 40, OUTLIER, NO_OUTPUT}, // 56
+    {600, 40, OK, 40},             // 74
+    {660, 40, OK, 40},
+};
+
+// 换了目标（20到380cm）且采样很快：连续剔除超过上限后重新建立基准
+static const Range_Vector reseed[] = {
+    {0, 20, OK, 20},
+    {10, 20, OK, 20},
+    {20, 20, OK, 20},
+    {30, 20, OK, 20},
+    {40, 20, OK, 20},
+    {50, 380, OK, 20},
+    {60, 380, OK, 20},
+    {70, 380, OUTLIER, NO_OUTPUT},
+    {80, 380, OUTLIER, NO_OUTPUT},
+    {90, 380, OUTLIER, NO_OUTPUT},
+    {100, 380, OUTLIER, NO_OUTPUT},
+    {110, 380, OUTLIER, NO_OUTPUT},
+    {120, 380, OK, 380},
+    {130, 380, OK, 380},
+};
+
+#define SEQUENCE(v) v, sizeof(v) / sizeof(v[0])
+
+//                               total ok timeout no_echo outlier reseed
+static const Range_Sequence sequences[] = {
+    {"spurious", SEQUENCE(spurious), {13, 13, 0, 0, 0, 0}},
+    {"early", SEQUENCE(early), {4, 3, 0, 0, 1, 0}},
+    {"timeout", SEQUENCE(timeout), {8, 4, 2, 2, 0, 0}},
+    {"step", SEQUENCE(step), {12, 9, 0, 0, 3, 0}},
+    {"reseed", SEQUENCE(reseed), {14, 9, 0, 0, 5, 1}},
+};
+
+static bool Same_Counters(const Range_Counters *a, const Range_Counters *b) {
+  return a->total == b->total && a->ok == b->ok && a->timeout == b->timeout &&
+         a->no_echo == b->no_echo && a->outlier == b->outlier &&
+         a->reseed == b->reseed;
+}
+
+static void Print_Counters(const char *label, const Range_Counters *c) {
+  printf("  %s total %u ok %u timeout %u no_echo %u outlier %u reseed %u\n",
+         label, c->total, c->ok, c->timeout, c->no_echo, c->outlier,
+         c->reseed);
+}
+
+static bool Run_Sequence(const Range_Sequence *s) {
+  Range_Validator rv;
+  bool ok = true;
+  Range_Validator_Init(&rv);
+
+  for (int i = 0; i < s->count; i++) {
+    const Range_Vector *v = &s->vectors[i];
+    float output = NO_OUTPUT;
+    Range_Status status = Range_Validator_Update(&rv, v->raw, v->t, &output);
+
+    if (status != v->status || rv.status != v->status ||
+        fabsf(output - v->output) > 1e-4f) {
+      printf("  %s #%d t=%u raw %.1f: got %s %.1f, expected %s %.1f\n",
+             s->name, i, v->t, v->raw, Range_Status_Name(status), output,
+             Range_Status_Name(v->status), v->output);
+      ok = false;
+    }
+  }
+
+  if (!Same_Counters(&rv.counters, &s->counters)) {
+    Print_Counters("got     ", &rv.counters);
+    Print_Counters("expected", &s->counters);
+    ok = false;
+  }
+  printf("%-9s %3d vectors%s\n", s->name, s->count, ok ? "" : "  FAIL");
+  return ok;
+}
+
+int main(void) {
+  bool pass = true;
+  for (size_t i = 0; i < sizeof(sequences) / sizeof(sequences[0]); i++) {
+    pass = Run_Sequence(&sequences[i]) && pass;
+  }
+  printf(pass ? "PASS\n" : "FAIL\n");
+  return pass ? 0 : 1;
+}
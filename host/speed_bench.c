@@ -0,0 +1,123 @@
+// 轮速测量基准：合成正交编码器脉冲序列（含刻线相位误差），按1kHz采样，
+// 比较按采样周期差分（M法）和 wheel_speed.c（M/T法）的速度误差
+// 用法：gcc -O2 -I. -o speed_bench host/speed_bench.c wheel_speed.c -lm
+//       ./speed_bench [seed]
+// 每种速度曲线上M/T法的误差都小于10ms差分时输出 PASS 并返回0，否则返回1
+
+#include "odometry.h"
+#include "wheel_speed.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SAMPLE_US 1000        // 采样周期（1kHz）
+#define PROFILE_US 6000000    // 每条曲线的仿真时长
+#define START_US 0xFFD23940u  // 起始时刻，仿真中途跨过32位回绕
+#define PHASE_ERROR 0.15f     // 四个边沿相对理想位置的最大偏差（计数）
+#define SETTLE_US 200000      // 起步后不计入统计的时间
+
+typedef struct {
+  const char *name;
+  float (*speed)(float t); // 真实速度 (cm/s)，t为秒
+} Profile;
+
+static float Crawl(float t) {
+  (void)t;
+  return 2.0f;
+}
+static float Slow(float t) {
+  (void)t;
+  return 10.0f;
+}
+static float Cruise(float t) {
+  (void)t;
+  return 83.0f;
+}
+static float Ramp(float t) { return (t < 3.0f) ? 40.0f * t : 40.0f * (6 - t); }
+static float Reverse(float t) { return 20.0f * sinf(2.0f * 3.14159265f * t); }
+static float Stop_Go(float t) { return (fmodf(t, 2.0f) < 1.0f) ? 30.0f : 0.0f; }
+
+static const Profile profiles[] = {
+    {"crawl", Crawl},     {"slow", Slow},       {"cruise", Cruise},
+    {"ramp", Ramp},       {"reverse", Reverse}, {"stop-go", Stop_Go},
+};
+
+typedef struct {
+  double sum_sq;
+  uint32_t n;
+} Rms;
+
+static void Rms_Add(Rms *r, float error) {
+  r->sum_sq += (double)error * error;
+  r->n++;
+}
+
+static float Rms_Get(const Rms *r) {
+  return (r->n > 0) ? (float)sqrt(r->sum_sq / r->n) : 0.0f;
+}
+
+int main(int argc, char **argv) {
+  uint32_t seed = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1;
+  bool pass = true;
+  srand(seed);
+
+  // 刻线误差：一个正交周期内四个边沿的固定偏差
+  float phase[4];
+  for (int k = 0; k < 4; k++) {
+    phase[k] = PHASE_ERROR * (2.0f * rand() / RAND_MAX - 1.0f);
+  }
+
+  printf("profile   M 1ms(cm/s)  M 10ms(cm/s)  M/T(cm/s)  M/T max\n");
+  for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+    Wheel_Speed ws;
+    Wheel_Speed_Init(&ws);
+    Rms m1 = {0}, m10 = {0}, mt = {0};
+    float mt_max = 0.0f;
+    double position = 0.0; // 真实位置（计数）
+    int32_t count = 0;     // 正交解码的累计值
+    uint32_t edge_us = START_US;
+    int32_t history[10] = {0};
+
+    for (uint32_t t = 1; t <= PROFILE_US; t++) {
+      float v = profiles[p].speed(t * 1e-6f) * ODOM_ENCODER_PER_CM;
+      position += v * 1e-6;
+
+      // 越过下一个（或上一个）边沿时计数，定时器捕获边沿时刻
+      while (position >= count + 1 + phase[(count + 1) & 3]) {
+        count++;
+        edge_us = START_US + t;
+      }
+      while (position < count + phase[count & 3]) {
+        count--;
+        edge_us = START_US + t;
+      }
+      if (t % SAMPLE_US != 0)
+        continue;
+
+      uint32_t now_us = START_US + t;
+      uint32_t k = t / SAMPLE_US;
+      float truth = v / ODOM_ENCODER_PER_CM;
+      float m_1ms = (count - history[(k + 9) % 10]) * (1e6f / SAMPLE_US);
+      float m_10ms = (count - history[k % 10]) * (1e6f / (10 * SAMPLE_US));
+      history[k % 10] = count;
+      Wheel_Speed_Update(&ws, count, edge_us, now_us);
+
+      if (t < SETTLE_US)
+        continue;
+      float error = Wheel_Speed_Cm_S(&ws) - truth;
+      Rms_Add(&m1, m_1ms / ODOM_ENCODER_PER_CM - truth);
+      Rms_Add(&m10, m_10ms / ODOM_ENCODER_PER_CM - truth);
+      Rms_Add(&mt, error);
+      if (fabsf(error) > mt_max)
+        mt_max = fabsf(error);
+    }
+
+    bool ok = Rms_Get(&mt) < Rms_Get(&m10);
+    pass = pass && ok;
+    printf("%-9s %11.3f %13.3f %10.3f %8.3f%s\n", profiles[p].name,
+           Rms_Get(&m1), Rms_Get(&m10), Rms_Get(&mt), mt_max,
+           ok ? "" : "  FAIL");
+  }
+  printf(pass ? "PASS\n" : "FAIL\n");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// 巡线跑圈基准：在全部内置赛道上运行 Track_Update，输出圈速、横向误差和丢线统计
+// 用法：gcc -O2 -Ihost -I. -o track_bench host/track_bench.c host/track_sim.c
+//           host/bsp_host.c ccd_process.c line_tracking.c motor_output.c
+//           odometry.c -lm
+//       ./track_bench [seed] [赛道名] [-t] [-p]
+//       -t 输出最后一次仿真的电机命令时间线
+//       -p 用纯追踪转向律（默认为PID）
+
+#include "track_sim.h"
+#include "bsp.h"
+#include "line_tracking.h"
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char **argv) {
+  uint32_t seed = 1;
+  const char *only = NULL;
+  bool dump = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-t") == 0)
+      dump = true;
+    else if (strcmp(argv[i], "-p") == 0)
+      track_config.steer_mode = STEER_PURSUIT;
+    else if (argv[i][0] >= '0' && argv[i][0] <= '9')
+      seed = (uint32_t)strtoul(argv[i], NULL, 0);
+    else
+      only = argv[i];
+  }
+
+  printf("%-9s %-7s %8s %8s %9s %8s %8s %5s %7s\n", "track", "result",
+         "lap(ms)", "dist(cm)", "avg(cm/s)", "max(cm)", "rms(cm)", "loss",
+         "lost%");
+
+  int failures = 0;
+  uint32_t total_ms = 0;
+  for (int k = 0; k < Sim_Track_Count; k++) {
+    if (only != NULL && strcmp(only, Sim_Tracks[k].name) != 0)
+      continue;
+
+    Sim_Course course;
+    if (!Sim_Course_Build(&course, &Sim_Tracks[k])) {
+      fprintf(stderr, "%s: out of memory\n", Sim_Tracks[k].name);
+      return 2;
+    }
+    Sim_Result r = Sim_Run(&course, seed, NULL);
+    printf("%-9s %-7s %8u %8.0f %9.1f %8.2f %8.2f %5u %6.1f%%\n",
+           Sim_Tracks[k].name, Sim_Outcome_Name(r.outcome), r.lap_ms,
+           r.distance, r.distance * 1000.0f / r.lap_ms, r.max_error,
+           r.rms_error, r.loss_count, 100.0f * r.lost_frames / r.frames);
+    Sim_Course_Free(&course);
+
+    if (r.outcome == SIM_FINISHED)
+      total_ms += r.lap_ms;
+    else
+      failures++;
+  }
+  printf("total %u ms, %d not finished (seed %u)\n", total_ms, failures, seed);
+
+  if (dump)
+    Host_Motor_Timeline_Dump(stdout);
+  return failures;
+}
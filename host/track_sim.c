@@ -0,0 +1,549 @@
+// 巡线闭环主机仿真实现（接口见 track_sim.h）
+
+#include "track_sim.h"
+#include "bsp_ccd.h"
+#include "line_tracking.h"
+#include "motor_output.h"
+#include "odometry.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define SIM_PI 3.14159265f
+#define SIM_SEARCH_WINDOW 40 // 最近点局部搜索范围（中线采样点数，单侧）
+
+// ---------------------------------------------------------------------------
+// 内置赛道
+
+// 弯道半径按原巡线参数的转向能力选取：最低速300、最大差速200时
+// 最小转弯半径约115cm（tight赛道故意低于该值，用于考察转向能力）
+
+// 椭圆：两条直道 + 两个180度弯
+static const Sim_Segment oval[] = {
+    {150, 0, 0}, {0, 130, 180}, {150, 0, 0}, {0, 130, 180}};
+
+// 小半径椭圆
+static const Sim_Segment tight[] = {
+    {100, 0, 0}, {0, 80, 180}, {100, 0, 0}, {0, 80, 180}};
+
+// 长直道高速椭圆
+static const Sim_Segment fast[] = {
+    {300, 0, 0}, {0, 150, 180}, {300, 0, 0}, {0, 150, 180}};
+
+// 直道中插入S弯，上下两侧对称保证闭合
+static const Sim_Segment chicane[] = {
+    {40, 0, 0}, {0, 150, 45}, {0, 150, -45}, {40, 0, 0}, {0, 130, 180},
+    {40, 0, 0}, {0, 150, 45}, {0, 150, -45}, {40, 0, 0}, {0, 130, 180}};
+
+// 八字：中心自交叉，两个270度弯方向相反
+static const Sim_Segment figure8[] = {
+    {130, 0, 0}, {0, 130, -270}, {260, 0, 0}, {0, 130, 270}, {130, 0, 0}};
+
+// 两条直道中点处的横线
+static const float oval_crossings[] = {75, 75 + 150 + 130 * SIM_PI};
+
+// 断线：两条直道中点和两个弯道中点各一处
+static const float oval_gaps[] = {75, 150 + 65 * SIM_PI, 225 + 130 * SIM_PI,
+                                  300 + 195 * SIM_PI};
+
+#define COUNT(s) (sizeof(s) / sizeof(s[0]))
+#define SEGMENTS(s) .segments = s, .segment_count = COUNT(s)
+#define PLAIN .shadow_level = 1, .noise_scale = 1 // 无阴影、标准噪声
+
+const Sim_Track_Desc Sim_Tracks[] = {
+    {.name = "oval", SEGMENTS(oval), PLAIN},
+    {.name = "tight", SEGMENTS(tight), PLAIN},
+    {.name = "fast", SEGMENTS(fast), PLAIN},
+    {.name = "chicane", SEGMENTS(chicane), PLAIN},
+    {.name = "figure8", SEGMENTS(figure8), PLAIN},
+    {.name = "crossing",
+     SEGMENTS(oval),
+     PLAIN,
+     .crossings = oval_crossings,
+     .crossing_count = COUNT(oval_crossings),
+     .crossing_length = 40},
+    {.name = "lighting",
+     SEGMENTS(oval),
+     .light_gradient = 0.4f,
+     .shadow_x0 = 60,
+     .shadow_x1 = 120,
+     .shadow_level = 0.45f,
+     .noise_scale = 2},
+    {.name = "gaps",
+     SEGMENTS(oval),
+     PLAIN,
+     .gaps = oval_gaps,
+     .gap_count = COUNT(oval_gaps),
+     .gap_length = 25},
+};
+
+const int Sim_Track_Count = sizeof(Sim_Tracks) / sizeof(Sim_Tracks[0]);
+
+// ---------------------------------------------------------------------------
+// 随机数（每次仿真按种子重置，保证结果可复现）
+
+static uint32_t rng_state;
+
+static float Rand_Uniform(void) {
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return (rng_state >> 8) / 16777216.0f;
+}
+
+static float Rand_Gauss(void) {
+  float u1 = Rand_Uniform() + 1e-7f;
+  float u2 = Rand_Uniform();
+  return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * SIM_PI * u2);
+}
+
+// ---------------------------------------------------------------------------
+// 赛道预处理
+
+// 按段拼接中线，返回采样点数（x为NULL时只计数）
+static int Trace_Path(const Sim_Track_Desc *desc, float *x, float *y,
+                      float *heading) {
+  float px = 0.0f, py = 0.0f, ph = 0.0f;
+  int n = 0;
+
+  for (int s = 0; s < desc->segment_count; s++) {
+    const Sim_Segment *seg = &desc->segments[s];
+    float turn = seg->turn_deg * (SIM_PI / 180.0f);
+    float length =
+        (seg->length > 0.0f) ? seg->length : seg->radius * fabsf(turn);
+    int steps = (int)ceilf(length / SIM_PATH_STEP_CM);
+    float ds = length / steps;
+    float k = (seg->length > 0.0f) ? 0.0f : turn / length; // 曲率
+
+    for (int i = 0; i < steps; i++) {
+      if (x != NULL) {
+        x[n] = px;
+        y[n] = py;
+        heading[n] = ph;
+      }
+      n++;
+      if (k == 0.0f) {
+        px += ds * cosf(ph);
+        py += ds * sinf(ph);
+      } else {
+        float h = ph + k * ds;
+        px += (sinf(h) - sinf(ph)) / k;
+        py -= (cosf(h) - cosf(ph)) / k;
+        ph = h;
+      }
+    }
+  }
+  return n;
+}
+
+static void Paint_Disc(Sim_Course *c, float x, float y, float radius) {
+  int cx = (int)((x - c->min_x) / SIM_RASTER_CM);
+  int cy = (int)((y - c->min_y) / SIM_RASTER_CM);
+  int r = (int)ceilf(radius / SIM_RASTER_CM);
+
+  for (int j = -r; j <= r; j++) {
+    for (int i = -r; i <= r; i++) {
+      if (i * i + j * j > r * r)
+        continue;
+      int gx = cx + i, gy = cy + j;
+      if (gx >= 0 && gx < c->raster_w && gy >= 0 && gy < c->raster_h)
+        c->raster[gy * c->raster_w + gx] = 1;
+    }
+  }
+}
+
+bool Sim_Course_Build(Sim_Course *c, const Sim_Track_Desc *desc) {
+  c->desc = desc;
+  c->count = Trace_Path(desc, NULL, NULL, NULL);
+  c->length = c->count * SIM_PATH_STEP_CM;
+  c->x = malloc(c->count * sizeof(float));
+  c->y = malloc(c->count * sizeof(float));
+  c->heading = malloc(c->count * sizeof(float));
+  if (c->x == NULL || c->y == NULL || c->heading == NULL)
+    return false;
+  Trace_Path(desc, c->x, c->y, c->heading);
+
+  // 位图范围：中线外扩出CCD可能看到的区域
+  float margin = SIM_OFF_TRACK_CM + SIM_CCD_LOOKAHEAD_CM + SIM_CCD_VIEW_CM;
+  float max_x = c->x[0], max_y = c->y[0];
+  c->min_x = c->x[0];
+  c->min_y = c->y[0];
+  for (int i = 1; i < c->count; i++) {
+    c->min_x = fminf(c->min_x, c->x[i]);
+    c->min_y = fminf(c->min_y, c->y[i]);
+    max_x = fmaxf(max_x, c->x[i]);
+    max_y = fmaxf(max_y, c->y[i]);
+  }
+  c->min_x -= margin;
+  c->min_y -= margin;
+  c->raster_w = (int)((max_x + margin - c->min_x) / SIM_RASTER_CM) + 1;
+  c->raster_h = (int)((max_y + margin - c->min_y) / SIM_RASTER_CM) + 1;
+  c->raster = calloc((size_t)c->raster_w * c->raster_h, 1);
+  if (c->raster == NULL)
+    return false;
+
+  for (int i = 0; i < c->count; i++) {
+    float s = i * SIM_PATH_STEP_CM;
+    bool gap = false;
+    for (int k = 0; k < desc->gap_count; k++) {
+      if (s >= desc->gaps[k] && s < desc->gaps[k] + desc->gap_length)
+        gap = true;
+    }
+    if (!gap)
+      Paint_Disc(c, c->x[i], c->y[i], SIM_LINE_WIDTH_CM / 2);
+  }
+
+  // 横线：在指定位置沿法向画线
+  for (int k = 0; k < desc->crossing_count; k++) {
+    int i = (int)(desc->crossings[k] / SIM_PATH_STEP_CM) % c->count;
+    float nx = -sinf(c->heading[i]), ny = cosf(c->heading[i]);
+    for (float t = -desc->crossing_length / 2; t <= desc->crossing_length / 2;
+         t += SIM_PATH_STEP_CM) {
+      Paint_Disc(c, c->x[i] + nx * t, c->y[i] + ny * t, SIM_LINE_WIDTH_CM / 2);
+    }
+  }
+  return true;
+}
+
+void Sim_Course_Free(Sim_Course *c) {
+  free(c->x);
+  free(c->y);
+  free(c->heading);
+  free(c->raster);
+  c->x = c->y = c->heading = NULL;
+  c->raster = NULL;
+}
+
+// ---------------------------------------------------------------------------
+// CCD成像
+
+static const Sim_Course *active_course;
+static float pose_x, pose_y, pose_h;
+static float pixel_gain[128]; // 像素响应（渐晕 x 不一致性）
+static const uint8_t *replay_pixels; // 非NULL时RD_TSL回放录制帧
+static uint8_t replay_exposure;
+
+static bool Ink_At(const Sim_Course *c, float x, float y) {
+  int gx = (int)((x - c->min_x) / SIM_RASTER_CM);
+  int gy = (int)((y - c->min_y) / SIM_RASTER_CM);
+  if (gx < 0 || gx >= c->raster_w || gy < 0 || gy >= c->raster_h)
+    return false;
+  return c->raster[gy * c->raster_w + gx];
+}
+
+static float Light_At(const Sim_Track_Desc *d, float x) {
+  float light = 1.0f + d->light_gradient * x / 100.0f;
+  if (x >= d->shadow_x0 && x < d->shadow_x1)
+    light *= d->shadow_level;
+  return (light > 0.1f) ? light : 0.1f;
+}
+
+// 合成一帧（代替bsp_ccd.c中的硬件采集，输出格式相同：12位ADC右移4位）
+// 回放日志时改为输出按曝光缩放后的录制帧
+void RD_TSL(void) {
+  const Sim_Course *c = active_course;
+  if (replay_pixels != NULL) {
+    float scale = (float)ccd.exposure_time / replay_exposure;
+    for (int i = 0; i < 128; i++) {
+      float value = replay_pixels[i] * scale;
+      ccd.raw_data[i] = (value < 255.0f) ? (uint8_t)value : 255;
+    }
+    return;
+  }
+
+  const float pitch = SIM_CCD_VIEW_CM / 128;
+  float cx = pose_x + SIM_CCD_LOOKAHEAD_CM * cosf(pose_h);
+  float cy = pose_y + SIM_CCD_LOOKAHEAD_CM * sinf(pose_h);
+  float nx = -sinf(pose_h), ny = cosf(pose_h); // 左侧法向
+
+  for (int i = 0; i < 128; i++) {
+    // 线在左边时CCD_median > 64：像素序号向左增大；每像素取两个子采样
+    float reflect = 0.0f;
+    for (int sub = 0; sub < 2; sub++) {
+      float offset = (i - 63.5f + (sub - 0.5f) * 0.5f) * pitch;
+      float x = cx + nx * offset, y = cy + ny * offset;
+      reflect += Ink_At(c, x, y) ? SIM_BLACK : SIM_WHITE;
+    }
+    reflect *= 0.5f;
+
+    float light = Light_At(c->desc, cx + nx * (i - 63.5f) * pitch);
+    float adc = reflect * light * pixel_gain[i] * ccd.exposure_time *
+                    SIM_ADC_PER_EXPOSURE +
+                SIM_PIXEL_NOISE * c->desc->noise_scale * Rand_Gauss();
+    if (adc < 0.0f)
+      adc = 0.0f;
+    if (adc > 4095.0f)
+      adc = 4095.0f;
+
+    ccd.raw_data[i] = (uint16_t)adc >> 4;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// 仿真主循环
+
+// 在上次位置附近查找最近的中线点（局部搜索避免在交叉处跳到另一条支路）
+static int Nearest_Index(const Sim_Course *c, int last, float x, float y,
+                         float *lateral) {
+  int best = last;
+  float best_d2 = 1e30f;
+  for (int k = -SIM_SEARCH_WINDOW; k <= SIM_SEARCH_WINDOW; k++) {
+    int i = (last + k + c->count) % c->count;
+    float dx = x - c->x[i], dy = y - c->y[i];
+    float d2 = dx * dx + dy * dy;
+    if (d2 < best_d2) {
+      best_d2 = d2;
+      best = i;
+    }
+  }
+  // 带符号横向误差：中线左侧为正
+  *lateral = -(x - c->x[best]) * sinf(c->heading[best]) +
+             (y - c->y[best]) * cosf(c->heading[best]);
+  return best;
+}
+
+static void Reset_Ccd(void) {
+  memset(&ccd, 0, sizeof(ccd));
+  ccd.exposure_time = 10;
+  CCD_median = 64;
+  CCD_threshold = 128;
+}
+
+Sim_Result Sim_Run(const Sim_Course *c, uint32_t seed,
+                   const Sim_Controller *controller) {
+  Sim_Result r = {0};
+  float wheel_gain[4], wheel_speed[4] = {0}, wheel_travel[4] = {0};
+  float err_sq = 0.0f;
+  int index = 0, progress = 0;
+  bool had_line = true;
+
+  rng_state = seed;
+  active_course = c;
+  for (int i = 0; i < 4; i++) {
+    wheel_gain[i] = 1.0f + SIM_WHEEL_GAIN_SPREAD * (2.0f * Rand_Uniform() - 1);
+  }
+  for (int i = 0; i < 128; i++) {
+    float u = (i - 63.5f) / 63.5f;
+    pixel_gain[i] = (1.0f - SIM_VIGNETTING * u * u) *
+                    (1.0f + SIM_FIXED_PATTERN * (2.0f * Rand_Uniform() - 1));
+  }
+
+  // 起点：中线起点附近，带少量随机偏移
+  float lateral0 = 2.0f * Rand_Uniform() - 1.0f;
+  pose_h = c->heading[0] + (4.0f * Rand_Uniform() - 2.0f) * (SIM_PI / 180.0f);
+  pose_x = c->x[0] - lateral0 * sinf(c->heading[0]);
+  pose_y = c->y[0] + lateral0 * cosf(c->heading[0]);
+
+  Host_Set_Tick(0);
+  Host_Motor_Timeline_Clear();
+  Reset_Ccd();
+  Motor_Output_Init();
+  if (controller != NULL)
+    controller->init();
+  else
+    Track_Init();
+
+  r.outcome = SIM_TIMEOUT;
+  for (uint32_t t = 0; t < SIM_TIMEOUT_MS; t++) {
+    Host_Set_Tick(t);
+
+    // 控制周期：合成帧 -> CCD处理 -> 控制器
+    if (t % SIM_CONTROL_PERIOD_MS == 0) {
+      Deal_Data_CCD();
+      if (controller != NULL) {
+        controller->step();
+      } else {
+        // 编码器计数：各侧两轮行驶距离的均值
+        Track_Update_Odometry(
+            (int32_t)((wheel_travel[0] + wheel_travel[1]) / 2 *
+                      ODOM_ENCODER_PER_CM),
+            (int32_t)((wheel_travel[2] + wheel_travel[3]) / 2 *
+                      ODOM_ENCODER_PER_CM));
+        Track_Update();
+      }
+      Motor_Output_Tick(); // 同 Mode_Manager_Step
+
+      bool has_line = ccd.line_width != 0;
+      if (had_line && !has_line)
+        r.loss_count++;
+      if (!has_line)
+        r.lost_frames++;
+      had_line = has_line;
+      r.frames++;
+    }
+
+    // 车辆动力学（1ms步长）：各轮一阶响应，左右两侧取平均后按差速运动
+    const int16_t *pwm = Host_Motor_Pwm();
+    for (int i = 0; i < 4; i++) {
+      float target = (ABS(pwm[i]) > SIM_MOTOR_DEADBAND)
+                         ? pwm[i] / SIM_PWM_PER_CM_S * wheel_gain[i]
+                         : 0.0f;
+      wheel_speed[i] += (target - wheel_speed[i]) * (0.001f / SIM_MOTOR_TAU_S);
+      wheel_travel[i] += wheel_speed[i] * 0.001f;
+    }
+    float left = (wheel_speed[0] + wheel_speed[1]) / 2;
+    float right = (wheel_speed[2] + wheel_speed[3]) / 2;
+    float v = (left + right) / 2;
+    float omega = (right - left) / ODOM_TRACK_WIDTH_CM;
+    if (fabsf(v * omega) > SIM_MAX_LAT_ACCEL)
+      omega = copysignf(SIM_MAX_LAT_ACCEL / fmaxf(fabsf(v), 1e-3f), omega);
+
+    float mid_h = pose_h + omega * 0.0005f;
+    pose_x += v * 0.001f * cosf(mid_h);
+    pose_y += v * 0.001f * sinf(mid_h);
+    pose_h += omega * 0.001f;
+
+    // 统计：横向误差和沿中线的进度
+    float lateral;
+    int next = Nearest_Index(c, index, pose_x, pose_y, &lateral);
+    int step = next - index;
+    if (step > c->count / 2)
+      step -= c->count;
+    if (step < -c->count / 2)
+      step += c->count;
+    progress += step;
+    index = next;
+
+    err_sq += lateral * lateral;
+    if (fabsf(lateral) > r.max_error)
+      r.max_error = fabsf(lateral);
+    r.lap_ms = t + 1;
+
+    if (fabsf(lateral) > SIM_OFF_TRACK_CM) {
+      r.outcome = SIM_OFF_TRACK;
+      break;
+    }
+    if (progress >= c->count) {
+      r.outcome = SIM_FINISHED;
+      break;
+    }
+  }
+
+  Motor_Output_Stop(1);
+  r.distance = progress * SIM_PATH_STEP_CM;
+  r.rms_error = sqrtf(err_sq / r.lap_ms);
+  return r;
+}
+
+const char *Sim_Outcome_Name(Sim_Outcome outcome) {
+  switch (outcome) {
+  case SIM_FINISHED:
+    return "finish";
+  case SIM_OFF_TRACK:
+    return "off";
+  case SIM_TIMEOUT:
+    return "timeout";
+  default:
+    return "?";
+  }
+}
+
+// ---------------------------------------------------------------------------
+// CCD日志回放
+
+bool Sim_Log_Load(Sim_Log *log, const char *path) {
+  char line[1024];
+  int capacity = 0;
+  FILE *file = fopen(path, "r");
+
+  log->count = 0;
+  log->exposure = NULL;
+  log->pixels = NULL;
+  if (file == NULL)
+    return false;
+
+  while (fgets(line, sizeof(line), file) != NULL) {
+    char *p = line, *end;
+    if (line[0] == '#')
+      continue;
+    long exposure = strtol(p, &end, 10);
+    if (end == p || exposure <= 0 || exposure > 255)
+      continue;
+
+    if (log->count == capacity) {
+      capacity = capacity ? capacity * 2 : 256;
+      uint8_t *e = realloc(log->exposure, capacity);
+      uint8_t(*px)[128] = realloc(log->pixels, capacity * sizeof(*px));
+      if (e != NULL)
+        log->exposure = e;
+      if (px != NULL)
+        log->pixels = px;
+      if (e == NULL || px == NULL) {
+        fclose(file);
+        Sim_Log_Free(log);
+        return false;
+      }
+    }
+
+    // 像素不足128个的行丢弃（串口截断的帧）
+    int i;
+    for (i = 0, p = end; i < 128; i++, p = end) {
+      long value = strtol(p, &end, 10);
+      if (end == p)
+        break;
+      if (value < 0)
+        value = 0;
+      if (value > 255)
+        value = 255;
+      log->pixels[log->count][i] = (uint8_t)value;
+    }
+    if (i == 128)
+      log->exposure[log->count++] = (uint8_t)exposure;
+  }
+  fclose(file);
+  return log->count > 0;
+}
+
+void Sim_Log_Free(Sim_Log *log) {
+  free(log->exposure);
+  free(log->pixels);
+  log->exposure = NULL;
+  log->pixels = NULL;
+  log->count = 0;
+}
+
+Sim_Replay_Result Sim_Replay(const Sim_Log *log,
+                             const Sim_Controller *controller) {
+  Sim_Replay_Result r = {0};
+  float jitter = 0.0f;
+  int last_steer = 0;
+  bool had_line = true;
+
+  Host_Set_Tick(0);
+  Host_Motor_Timeline_Clear();
+  Reset_Ccd();
+  ccd.exposure_time = log->exposure[0];
+  Motor_Output_Init();
+  if (controller != NULL)
+    controller->init();
+  else
+    Track_Init();
+
+  for (int k = 0; k < log->count; k++) {
+    Host_Set_Tick((uint32_t)k * SIM_CONTROL_PERIOD_MS);
+    replay_pixels = log->pixels[k];
+    replay_exposure = log->exposure[k];
+    Deal_Data_CCD();
+    if (controller != NULL)
+      controller->step();
+    else
+      Track_Update();
+    Motor_Output_Tick();
+
+    const int16_t *pwm = Host_Motor_Pwm();
+    int steer = (pwm[2] + pwm[3]) - (pwm[0] + pwm[1]);
+    if (k > 0)
+      jitter += ABS(steer - last_steer) / 2.0f;
+    last_steer = steer;
+
+    bool has_line = ccd.line_width != 0;
+    if (had_line && !has_line)
+      r.loss_count++;
+    if (!has_line)
+      r.lost_frames++;
+    had_line = has_line;
+    r.frames++;
+  }
+
+  replay_pixels = NULL;
+  Motor_Output_Stop(1);
+  r.steer_jitter = (r.frames > 1) ? jitter / (r.frames - 1) : 0.0f;
+  return r;
+}
@@ -0,0 +1,123 @@
+#ifndef __TRACK_SIM_H
+#define __TRACK_SIM_H
+
+// 巡线闭环主机仿真：按赛道描述合成TSL1401帧送入ccd_process.c，
+// 由 Track_Update 输出的电机命令驱动四轮差速车辆模型，统计跑圈成绩
+// 仿真程序自身提供RD_TSL（代替bsp_ccd.c中的硬件采集）
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 车辆模型
+#define SIM_PWM_PER_CM_S 10.0f      // 稳态时每cm/s轮速对应的PWM
+#define SIM_MOTOR_TAU_S 0.12f       // 轮速一阶响应时间常数
+#define SIM_MOTOR_DEADBAND 150      // 低于该PWM车轮不转
+#define SIM_WHEEL_GAIN_SPREAD 0.03f // 各轮增益随机偏差（按种子生成）
+#define SIM_MAX_LAT_ACCEL 500.0f    // 侧向附着极限 (cm/s^2)，超过后转向不足
+
+// CCD成像
+#define SIM_CCD_LOOKAHEAD_CM 20.0f  // 视线中心到车体中心的前视距离
+#define SIM_CCD_VIEW_CM 21.0f       // 128像素覆盖的横向宽度（黑线约12像素）
+#define SIM_LINE_WIDTH_CM 2.0f      // 黑线宽度
+#define SIM_WHITE 0.85f             // 地面反射率
+#define SIM_BLACK 0.08f             // 黑线反射率
+#define SIM_ADC_PER_EXPOSURE 230.0f // 反射率1、照度1时每单位曝光的ADC值
+#define SIM_VIGNETTING 0.3f         // 边缘像素相对中心的亮度衰减
+#define SIM_PIXEL_NOISE 12.0f       // ADC读数噪声标准差（12位）
+#define SIM_FIXED_PATTERN 0.03f     // 像素响应不一致性
+
+// 仿真时序和判定
+#define SIM_CONTROL_PERIOD_MS 5 // 主循环周期（采集+控制）
+#define SIM_TIMEOUT_MS 60000    // 单圈超时
+#define SIM_OFF_TRACK_CM 25.0f  // 车体中心偏离中线超过该值判为出界
+#define SIM_PATH_STEP_CM 0.5f   // 赛道中线采样间隔
+#define SIM_RASTER_CM 0.15f     // 赛道位图分辨率
+
+// 赛道描述：从原点沿+x方向出发，按顺序拼接直线和圆弧
+typedef struct {
+  float length;   // 直线长度 (cm)，圆弧时为0
+  float radius;   // 圆弧半径 (cm)
+  float turn_deg; // 圆弧转角，正为左转
+} Sim_Segment;
+
+typedef struct {
+  const char *name;
+  const Sim_Segment *segments;
+  uint8_t segment_count;
+  const float *crossings; // 横线位置（沿中线的距离，cm）
+  uint8_t crossing_count;
+  float crossing_length; // 横线长度 (cm)
+  float light_gradient;  // 照度沿x方向每米的相对变化
+  float shadow_x0;       // 阴影带x范围 (cm)
+  float shadow_x1;
+  float shadow_level; // 阴影带内照度（1为无阴影）
+  float noise_scale;  // 噪声倍率
+  const float *gaps;  // 断线起点（沿中线的距离，cm）
+  uint8_t gap_count;
+  float gap_length; // 断线长度 (cm)
+} Sim_Track_Desc;
+
+// 预处理后的赛道：中线采样点 + 黑线位图
+typedef struct {
+  const Sim_Track_Desc *desc;
+  float *x, *y, *heading;
+  int count;
+  float length;
+  float min_x, min_y;
+  int raster_w, raster_h;
+  uint8_t *raster;
+} Sim_Course;
+
+typedef enum { SIM_FINISHED = 0, SIM_OFF_TRACK, SIM_TIMEOUT } Sim_Outcome;
+
+typedef struct {
+  Sim_Outcome outcome;
+  uint32_t lap_ms;
+  float distance;      // 沿中线完成的距离 (cm)
+  float max_error;     // 最大横向误差 (cm)
+  float rms_error;     // 均方根横向误差 (cm)
+  uint32_t loss_count; // 丢线次数（检测到线 -> 丢线的跳变）
+  uint32_t lost_frames;
+  uint32_t frames;
+} Sim_Result;
+
+// 被测控制器：每圈开始调用init，每个控制周期在CCD处理后调用step
+// 传NULL时使用 Track_Init / Track_Update
+typedef struct {
+  void (*init)(void);
+  void (*step)(void);
+} Sim_Controller;
+
+// 录制的CCD日志：文本文件，每行一帧"曝光时间 像素0 ... 像素127"，
+// 像素为RD_TSL的输出值（12位ADC右移4位），#开头的行为注释
+// 回放时按当前曝光时间与录制时曝光时间之比缩放像素，近似曝光控制的效果
+typedef struct {
+  int count;
+  uint8_t *exposure;
+  uint8_t (*pixels)[128];
+} Sim_Log;
+
+// 开环回放结果：车辆不随控制输出运动，只考察检测和转向输出的平稳性
+typedef struct {
+  uint32_t frames;
+  uint32_t lost_frames;
+  uint32_t loss_count;
+  float steer_jitter; // 相邻两帧左右轮差值变化量的平均值（PWM）
+} Sim_Replay_Result;
+
+// 内置赛道
+extern const Sim_Track_Desc Sim_Tracks[];
+extern const int Sim_Track_Count;
+
+// 函数声明
+bool Sim_Course_Build(Sim_Course *course, const Sim_Track_Desc *desc);
+void Sim_Course_Free(Sim_Course *course);
+Sim_Result Sim_Run(const Sim_Course *course, uint32_t seed,
+                   const Sim_Controller *controller);
+const char *Sim_Outcome_Name(Sim_Outcome outcome);
+bool Sim_Log_Load(Sim_Log *log, const char *path);
+void Sim_Log_Free(Sim_Log *log);
+Sim_Replay_Result Sim_Replay(const Sim_Log *log,
+                             const Sim_Controller *controller);
+
+#endif
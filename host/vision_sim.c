@@ -0,0 +1,354 @@
+// 视觉协处理器替身：按脚本生成 vision_link.h 协议的结果流
+// 用法：gcc -O2 -I. -o vision_sim host/vision_sim.c vision_link.c
+//           sensor_channel.c
+//       ./vision_sim <脚本> [串口 [-b 波特率]]
+// 给出串口时按脚本的时间间隔发给小车（代替相机接到USART2）；
+// 不给串口时在本机回环：字节按随机长度分段写入环形接收缓冲（模拟DMA和
+// 空闲中断），经 vision_link.c 解析后与脚本逐项比对，全部一致时输出 PASS
+// 脚本每行一条，#开头为注释：
+//   line <offset> <angle> <confidence>
+//   object <class> <label> <x> <y> <size> <confidence>
+//   cmd <code> <arg>
+//   wait <ms>                 与下一帧之间的间隔
+//   repeat <次数>             把上一条结果帧再发若干次
+//   noise <字节数>            插入随机字节（含SYNC）
+//   corrupt                   下一帧翻转一位，应被校验丢弃
+
+#include "vision_link.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SIM_MAX_BYTES 65536
+#define SIM_MAX_FRAMES 4096
+#define SIM_MAX_CHUNK 48 // 回环时每次中断最多到达的字节数
+
+// 脚本生成的一帧
+typedef struct {
+  uint8_t type;
+  uint8_t seq;
+  uint8_t payload[VISION_LINK_MAX_PAYLOAD];
+  uint8_t len;
+  uint32_t end;     // 帧末字节在字节流中的位置（不含）
+  uint32_t time_ms; // 发送时刻
+  bool corrupt;
+} Sim_Frame;
+
+static uint8_t stream[SIM_MAX_BYTES];
+static uint32_t stream_len = 0;
+static Sim_Frame frames[SIM_MAX_FRAMES];
+static int frame_count = 0;
+static int noise_frames = 0; // 噪声中可能混入的伪帧头，不计入比对
+
+static uint8_t Crc8(uint8_t crc, const uint8_t *data, int len) {
+  while (len--) {
+    crc ^= *data++;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static void Put_I16(uint8_t *dst, int value) {
+  dst[0] = value & 0xFF;
+  dst[1] = (value >> 8) & 0xFF;
+}
+
+// 把一帧追加到字节流
+static void Emit(Sim_Frame *f) {
+  uint8_t *p = &stream[stream_len];
+  p[0] = VISION_LINK_SYNC;
+  p[1] = f->type;
+  p[2] = f->seq;
+  p[3] = f->len;
+  memcpy(&p[4], f->payload, f->len);
+  p[4 + f->len] = Crc8(0, &p[1], 3 + f->len);
+  if (f->corrupt)
+    p[4 + rand() % (f->len + 1)] ^= 1 << (rand() % 8);
+  stream_len += 5 + f->len;
+  f->end = stream_len;
+}
+
+// 读脚本，生成字节流和帧表
+static bool Load_Script(const char *path) {
+  FILE *in = fopen(path, "r");
+  if (in == NULL) {
+    perror(path);
+    return false;
+  }
+
+  char line[256];
+  uint32_t time_ms = 0;
+  uint8_t seq = 0;
+  bool corrupt = false;
+  int number = 0;
+  while (fgets(line, sizeof(line), in) != NULL) {
+    number++;
+    char word[16];
+    int v[6];
+    if (sscanf(line, "%15s", word) != 1 || word[0] == '#')
+      continue;
+    if (stream_len + 64 > SIM_MAX_BYTES || frame_count + 1 >= SIM_MAX_FRAMES) {
+      fprintf(stderr, "%s:%d: script too long\n", path, number);
+      break;
+    }
+
+    Sim_Frame f = {0};
+    f.time_ms = time_ms;
+    f.corrupt = corrupt;
+    if (strcmp(word, "line") == 0 &&
+        sscanf(line, "%*s %d %d %d", &v[0], &v[1], &v[2]) == 3) {
+      f.type = VISION_MSG_LINE;
+      Put_I16(&f.payload[0], v[0]);
+      Put_I16(&f.payload[2], v[1]);
+      f.payload[4] = v[2];
+      f.len = 5;
+    } else if (strcmp(word, "object") == 0 &&
+               sscanf(line, "%*s %d %d %d %d %d %d", &v[0], &v[1], &v[2],
+                      &v[3], &v[4], &v[5]) == 6) {
+      f.type = VISION_MSG_OBJECT;
+      f.payload[0] = v[0];
+      f.payload[1] = v[1];
+      Put_I16(&f.payload[2], v[2]);
+      Put_I16(&f.payload[4], v[3]);
+      Put_I16(&f.payload[6], v[4]);
+      f.payload[8] = v[5];
+      f.len = 9;
+    } else if (strcmp(word, "cmd") == 0 &&
+               sscanf(line, "%*s %d %d", &v[0], &v[1]) == 2) {
+      f.type = VISION_MSG_COMMAND;
+      f.payload[0] = v[0];
+      Put_I16(&f.payload[1], v[1]);
+      f.len = 3;
+    } else if (strcmp(word, "wait") == 0 && sscanf(line, "%*s %d", &v[0]) == 1) {
+      time_ms += v[0];
+      continue;
+    } else if (strcmp(word, "repeat") == 0 &&
+               sscanf(line, "%*s %d", &v[0]) == 1 && frame_count > 0) {
+      Sim_Frame last = frames[frame_count - 1];
+      for (int i = 0; i < v[0] && frame_count + 1 < SIM_MAX_FRAMES &&
+                      stream_len + 64 <= SIM_MAX_BYTES;
+           i++) {
+        last.seq = seq++;
+        last.corrupt = false;
+        last.time_ms = time_ms;
+        Emit(&last);
+        frames[frame_count++] = last;
+      }
+      continue;
+    } else if (strcmp(word, "noise") == 0 &&
+               sscanf(line, "%*s %d", &v[0]) == 1) {
+      for (int i = 0; i < v[0] && stream_len < SIM_MAX_BYTES - 64; i++) {
+        uint8_t byte = (rand() % 4 == 0) ? VISION_LINK_SYNC : rand();
+        stream[stream_len++] = byte;
+      }
+      noise_frames++;
+      continue;
+    } else if (strcmp(word, "corrupt") == 0) {
+      corrupt = true;
+      continue;
+    } else {
+      fprintf(stderr, "%s:%d: bad line\n", path, number);
+      fclose(in);
+      return false;
+    }
+
+    f.seq = seq++;
+    Emit(&f);
+    frames[frame_count++] = f;
+    corrupt = false;
+  }
+  fclose(in);
+  return true;
+}
+
+static speed_t Baud_Constant(long baud) {
+  switch (baud) {
+  case 9600:
+    return B9600;
+  case 57600:
+    return B57600;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  default:
+    return B115200;
+  }
+}
+
+static int Open_Port(const char *path, long baud) {
+  struct termios tio;
+  int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0 || tcgetattr(fd, &tio) != 0)
+    return -1;
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, Baud_Constant(baud));
+  cfsetospeed(&tio, Baud_Constant(baud));
+  tcsetattr(fd, TCSANOW, &tio);
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+// 按脚本时间把字节流发到串口
+static int Send_Stream(const char *path, long baud) {
+  int port = Open_Port(path, baud);
+  if (port < 0) {
+    perror(path);
+    return 1;
+  }
+
+  uint32_t start = 0, now_ms = 0;
+  for (int i = 0; i < frame_count; i++) {
+    if (frames[i].time_ms > now_ms) {
+      struct timespec wait = {0, 0};
+      uint32_t ms = frames[i].time_ms - now_ms;
+      wait.tv_sec = ms / 1000;
+      wait.tv_nsec = (ms % 1000) * 1000000L;
+      nanosleep(&wait, NULL);
+      now_ms = frames[i].time_ms;
+    }
+    // 帧之前的噪声字节和本帧一起发出
+    if (write(port, &stream[start], frames[i].end - start) < 0) {
+      perror("write");
+      return 1;
+    }
+    start = frames[i].end;
+  }
+  if (start < stream_len && write(port, &stream[start], stream_len - start) < 0)
+    perror("write");
+  printf("sent %d frames, %u bytes\n", frame_count, stream_len);
+  close(port);
+  return 0;
+}
+
+static int16_t Get_I16(const uint8_t *src) {
+  return (int16_t)(src[0] | (src[1] << 8));
+}
+
+static bool Line_Matches(const Vision_Line *l, const Sim_Frame *f) {
+  return l->seq == f->seq && l->offset == Get_I16(&f->payload[0]) &&
+         l->angle == Get_I16(&f->payload[2]) &&
+         l->confidence == f->payload[4];
+}
+
+static bool Object_Matches(const Vision_Object *o, const Sim_Frame *f) {
+  return o->seq == f->seq && o->object_class == f->payload[0] &&
+         o->label == f->payload[1] && o->x == Get_I16(&f->payload[2]) &&
+         o->y == Get_I16(&f->payload[4]) &&
+         o->size == (uint16_t)Get_I16(&f->payload[6]) &&
+         o->confidence == f->payload[8];
+}
+
+// 检查快照是否为脚本中该类型最近的一帧
+// 噪声里的伪帧头会让解析器多等至多一帧长度的字节，这段时间内允许快照
+// 停在更早的帧上
+static bool Check_Latest(uint8_t type, const void *result, bool have,
+                         uint32_t fed) {
+  bool certain = false; // 该类型已有必然解析完的帧
+  bool matched = false;
+  for (int i = 0; i < frame_count && frames[i].end <= fed; i++) {
+    if (frames[i].corrupt || frames[i].type != type)
+      continue;
+    if (frames[i].end + VISION_LINK_MAX_PAYLOAD + 5 <= fed) {
+      certain = true;
+      matched = false; // 更早的帧不再算数
+    }
+    if (have && (type == VISION_MSG_LINE ? Line_Matches(result, &frames[i])
+                                         : Object_Matches(result, &frames[i])))
+      matched = true;
+  }
+  return have ? matched : !certain;
+}
+
+// 本机回环：分段写入接收缓冲并解析，逐段比对
+static int Loopback(void) {
+  uint8_t *rx = Vision_Link_Rx_Buffer();
+  uint32_t fed = 0;
+  int next_command = 0, commands = 0, corrupted = 0;
+  const char *error = NULL;
+
+  Vision_Link_Init();
+  while (fed < stream_len && error == NULL) {
+    uint32_t chunk = 1 + rand() % SIM_MAX_CHUNK;
+    if (chunk > stream_len - fed)
+      chunk = stream_len - fed;
+    for (uint32_t i = 0; i < chunk; i++) {
+      rx[(fed + i) % VISION_LINK_RX_SIZE] = stream[fed + i];
+    }
+    fed += chunk;
+    Vision_Link_Rx_Update(fed % VISION_LINK_RX_SIZE, fed);
+
+    // 指令按顺序逐条到达，校验错误的帧不应出现
+    Sensor_Event event;
+    while (error == NULL && Sensor_Ring_Pop(&vision_command_ring, &event)) {
+      while (next_command < frame_count &&
+             (frames[next_command].type != VISION_MSG_COMMAND ||
+              frames[next_command].corrupt))
+        next_command++;
+      const Sim_Frame *f =
+          (next_command < frame_count) ? &frames[next_command++] : NULL;
+      if (f == NULL || event.source != SENSOR_EVENT_VISION_CMD ||
+          event.flags != f->payload[0] ||
+          event.value != Get_I16(&f->payload[1]))
+        error = "command differs";
+      commands++;
+    }
+    Vision_Line line;
+    Vision_Object object;
+    bool have_line =
+        Sensor_Snapshot_Read(&vision_line_channel, &line, sizeof(line));
+    bool have_object =
+        Sensor_Snapshot_Read(&vision_object_channel, &object, sizeof(object));
+    if (error == NULL && !Check_Latest(VISION_MSG_LINE, &line, have_line, fed))
+      error = "line result differs";
+    if (error == NULL &&
+        !Check_Latest(VISION_MSG_OBJECT, &object, have_object, fed))
+      error = "object result differs";
+  }
+
+  int expected = 0;
+  for (int i = 0; i < frame_count; i++) {
+    if (frames[i].corrupt)
+      corrupted++;
+    else
+      expected++;
+  }
+
+  const Vision_Link_Stats *s = Vision_Link_Get_Stats();
+  printf("frames: script %d (corrupt %d), parsed %u, commands %d\n",
+         frame_count, corrupted, s->frames, commands);
+  printf("errors: crc %u, bad %u, lost %u, skipped bytes %u\n", s->crc_errors,
+         s->bad_frames, s->lost, s->skipped);
+  // 噪声中的伪帧头偶尔能通过校验，只在没有噪声时要求帧数完全一致
+  if (error == NULL && noise_frames == 0 && (int)s->frames != expected)
+    error = "parsed frame count differs";
+  if (error != NULL) {
+    printf("FAIL: %s (at byte %u)\n", error, fed);
+    return 1;
+  }
+  printf("PASS\n");
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <script> [port [-b baud]]\n", argv[0]);
+    return 2;
+  }
+  srand(1);
+  if (!Load_Script(argv[1]))
+    return 2;
+
+  if (argc >= 3) {
+    long baud = (argc >= 5 && strcmp(argv[3], "-b") == 0) ? atol(argv[4])
+                                                          : 115200;
+    return Send_Stream(argv[2], baud);
+  }
+  return Loopback();
+}
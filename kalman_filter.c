@@ -0,0 +1,134 @@
+#include "kalman_filter.h"
+
+// 初始速度方差：初始时刻对接近速度一无所知 (cm/s)^2
+#define KALMAN_INIT_VAR_V 10000.0f
+// 稳态增益迭代次数
+#define KALMAN_STEADY_ITER 200
+
+// 协方差预测：P = F*P*F' + Qd，F = [1 dt; 0 1]
+static void Predict_Covariance(float P[2][2], float q, float dt) {
+  float dt2 = dt * dt;
+  P[0][0] += dt * (P[0][1] + P[1][0]) + dt2 * P[1][1] + q * dt2 * dt / 3.0f;
+  P[0][1] += dt * P[1][1] + q * dt2 / 2.0f;
+  P[1][0] += dt * P[1][1] + q * dt2 / 2.0f;
+  P[1][1] += q * dt;
+}
+
+// 协方差更新（测量矩阵H = [1 0]），返回两个增益
+static void Update_Covariance(float P[2][2], float r, float *k_d, float *k_v) {
+  float s = P[0][0] + r;
+  *k_d = P[0][0] / s;
+  *k_v = P[1][0] / s;
+
+  float p00 = P[0][0];
+  float p01 = P[0][1];
+  P[0][0] -= *k_d * p00;
+  P[0][1] -= *k_d * p01;
+  P[1][0] -= *k_v * p00;
+  P[1][1] -= *k_v * p01;
+}
+
+static void Reset_Covariance(float P[2][2], float r) {
+  P[0][0] = r;
+  P[0][1] = 0.0f;
+  P[1][0] = 0.0f;
+  P[1][1] = KALMAN_INIT_VAR_V;
+}
+
+// 初始化浮点滤波器
+void Kalman_CV_Init(Kalman_CV *kf, float q, float r) {
+  kf->d = 0.0f;
+  kf->v = 0.0f;
+  kf->q = q;
+  kf->r = r;
+  kf->last_ms = 0;
+  kf->initialized = false;
+  Reset_Covariance(kf->P, r);
+}
+
+// 浮点滤波更新，dt由测量时间戳计算
+float Kalman_CV_Update(Kalman_CV *kf, float measurement, uint32_t now_ms) {
+  uint32_t dt_ms = now_ms - kf->last_ms;
+
+  // 首次测量或长时间无测量：直接用测量值重新初始化
+  if (!kf->initialized || dt_ms > KALMAN_MAX_DT_MS) {
+    kf->d = measurement;
+    kf->v = 0.0f;
+    kf->last_ms = now_ms;
+    kf->initialized = true;
+    Reset_Covariance(kf->P, kf->r);
+    return kf->d;
+  }
+
+  // 预测
+  if (dt_ms > 0) {
+    float dt = dt_ms * 0.001f;
+    kf->d += kf->v * dt;
+    Predict_Covariance(kf->P, kf->q, dt);
+    kf->last_ms = now_ms;
+  }
+
+  // 更新
+  float k_d, k_v;
+  Update_Covariance(kf->P, kf->r, &k_d, &k_v);
+  float residual = measurement - kf->d;
+  kf->d += k_d * residual;
+  kf->v += k_v * residual;
+
+  return kf->d;
+}
+
+// 接近速度 (cm/s)，正值表示目标正在靠近
+float Kalman_CV_Closing_Speed(const Kalman_CV *kf) { return -kf->v; }
+
+// 初始化定点滤波器：按标称周期离线迭代Riccati方程得到稳态增益
+void Kalman_CV_Fixed_Init(Kalman_CV_Fixed *kf, float q, float r,
+                          uint16_t nominal_dt_ms) {
+  float P[2][2];
+  float k_d = 1.0f, k_v = 0.0f;
+  float dt = nominal_dt_ms * 0.001f;
+
+  Reset_Covariance(P, r);
+  for (int i = 0; i < KALMAN_STEADY_ITER; i++) {
+    Predict_Covariance(P, q, dt);
+    Update_Covariance(P, r, &k_d, &k_v);
+  }
+
+  kf->k_d = (int32_t)(k_d * 65536.0f);
+  kf->k_v = (int32_t)(k_v * 65536.0f);
+  kf->d = 0;
+  kf->v = 0;
+  kf->last_ms = 0;
+  kf->initialized = false;
+}
+
+// 定点滤波更新：预测使用实际dt，增益使用稳态值
+float Kalman_CV_Fixed_Update(Kalman_CV_Fixed *kf, float measurement,
+                             uint32_t now_ms) {
+  int32_t z = (int32_t)(measurement * 256.0f);
+  uint32_t dt_ms = now_ms - kf->last_ms;
+
+  if (!kf->initialized || dt_ms > KALMAN_MAX_DT_MS) {
+    kf->d = z;
+    kf->v = 0;
+    kf->last_ms = now_ms;
+    kf->initialized = true;
+    return measurement;
+  }
+
+  // 预测
+  kf->d += (kf->v * (int32_t)dt_ms) / 1000;
+  kf->last_ms = now_ms;
+
+  // 更新
+  int32_t residual = z - kf->d;
+  kf->d += (int32_t)(((int64_t)kf->k_d * residual) >> 16);
+  kf->v += (int32_t)(((int64_t)kf->k_v * residual) >> 16);
+
+  return kf->d / 256.0f;
+}
+
+// 接近速度 (cm/s)，正值表示目标正在靠近
+float Kalman_CV_Fixed_Closing_Speed(const Kalman_CV_Fixed *kf) {
+  return -kf->v / 256.0f;
+}
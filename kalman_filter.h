@@ -0,0 +1,45 @@
+#ifndef __KALMAN_FILTER_H
+#define __KALMAN_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 双状态常速度模型卡尔曼滤波器：状态为 [距离, 距离变化率]
+// 纯算法模块，不依赖HAL，可直接在主机上编译
+
+// 时间间隔限制（毫秒）
+#define KALMAN_MAX_DT_MS 500 // 超过该间隔视为测量中断，重新初始化
+
+// 浮点版本：按测量时间戳计算可变dt，完整协方差更新
+typedef struct {
+  float d;       // 距离估计 (cm)
+  float v;       // 距离变化率 (cm/s)，负值表示正在接近
+  float P[2][2]; // 估计误差协方差
+  float q;       // 加速度过程噪声谱密度 ((cm/s^2)^2)
+  float r;       // 测量噪声方差 (cm^2)
+  uint32_t last_ms;
+  bool initialized;
+} Kalman_CV;
+
+// 定点版本：Q8状态 + 稳态增益（Q16），每次更新只有整数乘加
+typedef struct {
+  int32_t d;   // 距离估计 (cm, Q8)
+  int32_t v;   // 距离变化率 (cm/s, Q8)
+  int32_t k_d; // 距离稳态增益 (Q16)
+  int32_t k_v; // 速度稳态增益 (1/s, Q16)
+  uint32_t last_ms;
+  bool initialized;
+} Kalman_CV_Fixed;
+
+// 函数声明
+void Kalman_CV_Init(Kalman_CV *kf, float q, float r);
+float Kalman_CV_Update(Kalman_CV *kf, float measurement, uint32_t now_ms);
+float Kalman_CV_Closing_Speed(const Kalman_CV *kf);
+
+void Kalman_CV_Fixed_Init(Kalman_CV_Fixed *kf, float q, float r,
+                          uint16_t nominal_dt_ms);
+float Kalman_CV_Fixed_Update(Kalman_CV_Fixed *kf, float measurement,
+                             uint32_t now_ms);
+float Kalman_CV_Fixed_Closing_Speed(const Kalman_CV_Fixed *kf);
+
+#endif
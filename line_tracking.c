@@ -1,4 +1,22 @@
 #include "line_tracking.h"
+#include <math.h>
+
+#define DEG_TO_RAD 0.01745329f
+
+// 找线阶段
+typedef enum {
+  RECOVER_NONE = 0, // 正常巡线
+  RECOVER_EXTEND,   // 沿记录的线走向外推前进（断线、横线、弯道冲出）
+  RECOVER_RETURN,   // 外推无果：倒车回到最后看到线时的位姿
+  RECOVER_SEARCH,   // 以预计的线方向为中心原地左右扫描，幅度逐次加大
+  RECOVER_SPIN,     // 没有可用记录或扫描失败：朝最后的转向方向原地旋转
+} Recover_State;
+
+// 里程计坐标系中的点
+typedef struct {
+  float x;
+  float y;
+} Line_Point;
 
 // 运行状态结构体
 typedef struct {
@@ -6,11 +24,53 @@ typedef struct {
   int16_t current_speed;
   uint8_t lost_line_count;
   int8_t last_direction;
+  float integral;
+  float last_error;
   bool is_running;
+
+  // 轨迹记忆
+  Odometry odom;
+  bool odom_valid;
+  Line_Point last_seen;                   // 最后一次看到的线上点
+  Odometry last_pose;                     // 最后一次看到线时的车辆位姿
+  Line_Point history[TRACK_HISTORY_SIZE]; // 按行驶距离抽样的线上点
+  uint8_t history_head;
+  uint8_t history_count;
+  float record_travel; // 距上次记录的行驶距离 (cm)
+
+  // 找线
+  Recover_State recover;
+  uint16_t recover_frames;
+  float line_heading;     // 丢线时估计的线走向 (rad)
+  float recover_travel;   // 外推阶段的行驶距离 (cm)
+  float search_center;    // 扫描中心朝向 (rad)
+  float search_target;    // 当前转向目标朝向 (rad)
+  float search_amplitude; // 当前扫描半角 (rad)
+  int8_t search_side;     // 下一次扫描的方向（1为左）
 } Track_State;
 
 static Track_State track = {0};
 
+// 按CCD_median（0-127）预先计算的控制曲线，参数变化后自动重建
+typedef struct {
+  Track_Config config;   // 生成表时的参数
+  int16_t speed[128];    // 调整后速度（Adjust_Speed的结果）
+  float p_term[128];     // 比例项 kp * 偏差
+  float turn_scale[128]; // 转向缩放：调整后速度 / 基础速度
+} Track_Table;
+
+static Track_Table table;
+
+Track_Config track_config = {BASE_SPEED,     MAX_SPEED,
+                             MIN_SPEED,      MAX_SPEED_DIFF,
+                             LINE_LOST_THRESHOLD, PID_KP,
+                             PID_KI,         PID_KD,
+                             SPEED_REDUCE_RATIO,
+                             STEER_MODE_DEFAULT,
+                             PURSUIT_LOOKAHEAD_MIN_CM,
+                             PURSUIT_LOOKAHEAD_MAX_CM,
+                             PURSUIT_GAIN};
+
 // 限制数值范围
 static int16_t limit_value(int16_t value, int16_t min, int16_t max) {
   if (value > max)
@@ -20,31 +80,287 @@ static int16_t limit_value(int16_t value, int16_t min, int16_t max) {
   return value;
 }
 
+// 动态速度调整
+static int16_t Adjust_Speed(uint8_t line_width, float error) {
+  float speed_ratio = 1.0f;
+
+  // 根据偏差大小调整速度
+  float error_ratio = ABS(error) / 64.0f; // 归一化偏差
+
+  // 转弯时大幅降低速度
+  if (error_ratio > 0.1f) { // 偏差超过10%就开始降速
+    speed_ratio = 1.0f - (error_ratio * track_config.speed_reduce_ratio);
+    if (speed_ratio < 0.2f)
+      speed_ratio = 0.2f;
+  }
+
+  // 计算调整后的速度
+  int16_t adjusted_speed = (int16_t)(track_config.base_speed * speed_ratio);
+  return limit_value(adjusted_speed, track_config.min_speed,
+                     track_config.base_speed);
+}
+
+// 按当前参数重建控制曲线（与逐周期计算的结果完全相同）
+static void Build_Table(void) {
+  memcpy(&table.config, &track_config, sizeof(track_config));
+  for (int median = 0; median < 128; median++) {
+    float error = median - 64;
+    int16_t speed = Adjust_Speed(0, error);
+    table.speed[median] = speed;
+    table.p_term[median] = track_config.kp * error;
+    table.turn_scale[median] = (track_config.base_speed > 0)
+                                   ? (float)speed / track_config.base_speed
+                                   : 0.0f;
+  }
+}
+
 // 初始化巡线控制
 void Track_Init(void) {
-  track.base_speed = BASE_SPEED;
+  track.base_speed = track_config.base_speed;
   track.current_speed = 0;
   track.lost_line_count = 0;
   track.last_direction = 0;
+  track.integral = 0.0f;
+  track.last_error = 0.0f;
   track.is_running = true;
+  track.odom_valid = false;
+  track.history_head = 0;
+  track.history_count = 0;
+  track.record_travel = 0.0f;
+  track.recover = RECOVER_NONE;
+  Build_Table();
 }
 
-// 动态速度调整
-static int16_t Adjust_Speed(uint8_t line_width, float error) {
-  float speed_ratio = 1.0f;
+// 输入编码器累计值（左右两侧），每个控制周期在 Track_Update 之前调用
+// 不调用时丢线后退回原地旋转找线
+void Track_Update_Odometry(int32_t left_count, int32_t right_count) {
+  if (!track.odom_valid) {
+    Odometry_Init(&track.odom, left_count, right_count);
+    track.odom_valid = true;
+  } else {
+    Odometry_Update(&track.odom, left_count, right_count);
+    track.record_travel += ABS(track.odom.speed);
+    track.recover_travel += ABS(track.odom.speed);
+  }
+}
 
-  // 根据偏差大小调整速度
-  float error_ratio = ABS(error) / 64.0f; // 归一化偏差
+// 记录当前看到的线上点：CCD视线中心前视，按中线像素偏移换算横向位置
+static void Record_Line_Point(void) {
+  if (!track.odom_valid)
+    return;
 
-  // 转弯时大幅降低速度
-  if (error_ratio > 0.1f) {                    // 偏差超过10%就开始降速
-    speed_ratio = 1.0f - (error_ratio * 0.8f); // 最多降至20%速度
-    speed_ratio = limit_value(speed_ratio, 0.2f, 1.0f);
+  float offset = (CCD_median - 64) * TRACK_CCD_CM_PER_PIXEL; // 左侧为正
+  float c = cosf(track.odom.heading), s = sinf(track.odom.heading);
+  track.last_seen.x = track.odom.x + TRACK_CCD_LOOKAHEAD_CM * c - offset * s;
+  track.last_seen.y = track.odom.y + TRACK_CCD_LOOKAHEAD_CM * s + offset * c;
+  track.last_pose = track.odom;
+
+  if (track.history_count == 0 ||
+      track.record_travel >= TRACK_HISTORY_STEP_CM) {
+    track.history[track.history_head] = track.last_seen;
+    track.history_head = (track.history_head + 1) % TRACK_HISTORY_SIZE;
+    if (track.history_count < TRACK_HISTORY_SIZE)
+      track.history_count++;
+    track.record_travel = 0.0f;
+  }
+}
+
+// 线的走向：最早一条记录指向最后看到的点，记录太短时取车头方向
+static float Line_Heading(void) {
+  uint8_t oldest =
+      (track.history_head + TRACK_HISTORY_SIZE - track.history_count) %
+      TRACK_HISTORY_SIZE;
+  float dx = track.last_seen.x - track.history[oldest].x;
+  float dy = track.last_seen.y - track.history[oldest].y;
+  if (dx * dx + dy * dy < TRACK_HISTORY_STEP_CM * TRACK_HISTORY_STEP_CM)
+    return track.odom.heading;
+  return atan2f(dy, dx);
+}
+
+// 纯追踪：最早的线位置记录到本帧看到的点构成局部路径，
+// 在路径上取与车体中心相距前视距离的目标点（超出视线时沿线的走向外推），
+// 按 曲率 = 2*横向偏移/距离^2 换算左右轮差速；前视距离随速度加长
+// 目标点离车体中心太近（前视距离被设为0等）时曲率无意义，返回false改用PID
+static bool Pursuit_Turn(int16_t speed, int16_t *turn) {
+  float ratio = (track_config.max_speed > 0)
+                    ? (float)speed / track_config.max_speed
+                    : 0.0f;
+  float lookahead =
+      track_config.lookahead_min +
+      (track_config.lookahead_max - track_config.lookahead_min) * ratio;
+  float c = cosf(track.odom.heading), s = sinf(track.odom.heading);
+  uint8_t oldest =
+      (track.history_head + TRACK_HISTORY_SIZE - track.history_count) %
+      TRACK_HISTORY_SIZE;
+
+  // 依次检查路径点（车体坐标系：x向前，y向左），找到第一个超出前视距离的点
+  float px = 0.0f, py = 0.0f, pd = 0.0f; // 上一个路径点
+  float tx = 0.0f, ty = 0.0f;
+  bool found = false;
+  for (uint8_t k = 0; k <= track.history_count && !found; k++) {
+    uint8_t index = (oldest + k) % TRACK_HISTORY_SIZE;
+    const Line_Point *p =
+        (k < track.history_count) ? &track.history[index] : &track.last_seen;
+    float dx = p->x - track.odom.x, dy = p->y - track.odom.y;
+    float x = dx * c + dy * s, y = -dx * s + dy * c;
+    float d = sqrtf(x * x + y * y);
+    if (x > 0.0f && d >= lookahead) {
+      // 在上一段上线性插值到前视距离
+      float t = (k > 0 && d > pd) ? (lookahead - pd) / (d - pd) : 1.0f;
+      if (t < 0.0f)
+        t = 0.0f;
+      tx = px + (x - px) * t;
+      ty = py + (y - py) * t;
+      found = true;
+    }
+    px = x;
+    py = y;
+    pd = d;
+  }
+  if (!found) {
+    // 前视距离超出视线：从本帧看到的点沿线的走向外推
+    float heading = Line_Heading() - track.odom.heading;
+    float extend = lookahead - pd;
+    tx = px + extend * cosf(heading);
+    ty = py + extend * sinf(heading);
   }
 
-  // 计算调整后的速度
-  int16_t adjusted_speed = (int16_t)(BASE_SPEED * speed_ratio);
-  return limit_value(adjusted_speed, MIN_SPEED, BASE_SPEED);
+  float distance_sq = tx * tx + ty * ty;
+  if (distance_sq < PURSUIT_MIN_DISTANCE_CM * PURSUIT_MIN_DISTANCE_CM)
+    return false;
+  float curvature = 2.0f * ty / distance_sq;
+  float value = track_config.pursuit_gain * curvature *
+                (ODOM_TRACK_WIDTH_CM / 2.0f) * speed;
+
+  // 先在浮点下限幅再转换，超出int16范围时不会回绕成反向转向
+  float limit = track_config.max_speed_diff;
+  if (value > limit)
+    value = limit;
+  if (value < -limit)
+    value = -limit;
+  *turn = (int16_t)value;
+  return true;
+}
+
+// 回到最后看到线的位姿后规划扫描：沿线的走向外推，
+// 取与视线圆（半径为前视距离）的交点方向作为扫描中心
+static void Start_Search(void) {
+  float dx = track.last_seen.x - track.odom.x;
+  float dy = track.last_seen.y - track.odom.y;
+  float ux = cosf(track.line_heading), uy = sinf(track.line_heading);
+  float du = dx * ux + dy * uy;
+  float disc = du * du - (dx * dx + dy * dy) +
+               TRACK_CCD_LOOKAHEAD_CM * TRACK_CCD_LOOKAHEAD_CM;
+  float t = -du + sqrtf((disc > 0.0f) ? disc : 0.0f); // |D + t*u| = L 的较大根
+
+  track.search_center = atan2f(dy + t * uy, dx + t * ux);
+  track.search_target = track.search_center;
+  track.search_amplitude = TRACK_SEARCH_START_DEG * DEG_TO_RAD;
+  track.search_side = (track.last_direction >= 0) ? 1 : -1;
+  track.recover = RECOVER_SEARCH;
+}
+
+// 开始找线：有线位置记录时先沿线的走向外推，否则原地旋转
+// 线从视野侧面滑出（急弯转不过来）时外推只会离线更远，直接原地扫描
+static void Start_Recovery(void) {
+  track.recover_frames = 0;
+  track.recover_travel = 0.0f;
+  if (!track.odom_valid || track.history_count == 0) {
+    track.recover = RECOVER_SPIN;
+    return;
+  }
+  track.line_heading = Line_Heading();
+  if (ABS(CCD_median - 64) > TRACK_EDGE_EXIT_PX)
+    Start_Search();
+  else
+    track.recover = RECOVER_EXTEND;
+}
+
+// 原地转向目标朝向，返回是否已到达
+static bool Pivot_To(float heading) {
+  float error = Odometry_Wrap_Angle(heading - track.odom.heading);
+  if (ABS(error) < TRACK_HEADING_TOLERANCE_DEG * DEG_TO_RAD)
+    return true;
+  int16_t speed = (error > 0.0f) ? track_config.min_speed
+                                 : -track_config.min_speed;
+  Motor_Output_Set_LR(-speed, speed); // 左转时右轮前进
+  return false;
+}
+
+// 以最低速度驶向目标点（reverse为真时倒车），朝向偏差大时先原地转
+static void Drive_To(float x, float y, bool reverse) {
+  float heading = atan2f(y - track.odom.y, x - track.odom.x);
+  if (reverse)
+    heading += 3.14159265f; // 车尾对准目标
+  float bearing = Odometry_Wrap_Angle(heading - track.odom.heading);
+  if (ABS(bearing) > TRACK_PIVOT_ANGLE_DEG * DEG_TO_RAD) {
+    Pivot_To(heading);
+    return;
+  }
+
+  int16_t speed = reverse ? -track_config.min_speed : track_config.min_speed;
+  int16_t turn = (int16_t)(track_config.min_speed * bearing /
+                           (TRACK_PIVOT_ANGLE_DEG * DEG_TO_RAD));
+  Motor_Output_Set_LR(speed - turn, speed + turn);
+}
+
+// 丢线后的找线控制（每帧调用一次）
+static void Recover_Step(void) {
+  if (track.recover != RECOVER_SPIN &&
+      ++track.recover_frames > TRACK_RECOVER_MAX_FRAMES)
+    track.recover = RECOVER_SPIN;
+
+  switch (track.recover) {
+  case RECOVER_EXTEND: {
+    if (track.recover_travel > TRACK_EXTEND_CM) {
+      track.recover = RECOVER_RETURN;
+      break;
+    }
+    // 追踪外推直线上前视距离处的点
+    float ux = cosf(track.line_heading), uy = sinf(track.line_heading);
+    float along = (track.odom.x - track.last_seen.x) * ux +
+                  (track.odom.y - track.last_seen.y) * uy;
+    if (along < 0.0f)
+      along = 0.0f;
+    along += TRACK_CCD_LOOKAHEAD_CM;
+    Drive_To(track.last_seen.x + along * ux, track.last_seen.y + along * uy,
+             false);
+    break;
+  }
+
+  case RECOVER_RETURN: {
+    float dx = track.last_pose.x - track.odom.x;
+    float dy = track.last_pose.y - track.odom.y;
+    if (dx * dx + dy * dy <=
+        TRACK_RETURN_TOLERANCE_CM * TRACK_RETURN_TOLERANCE_CM) {
+      Start_Search();
+      break;
+    }
+    Drive_To(track.last_pose.x, track.last_pose.y, true);
+    break;
+  }
+
+  case RECOVER_SEARCH:
+    if (!Pivot_To(track.search_target))
+      break;
+    // 到达后转向另一侧，每次换向幅度加大半个步长
+    if (track.search_amplitude > TRACK_SEARCH_MAX_DEG * DEG_TO_RAD) {
+      track.recover = RECOVER_SPIN;
+      break;
+    }
+    track.search_target =
+        track.search_center + track.search_side * track.search_amplitude;
+    track.search_amplitude += TRACK_SEARCH_WIDEN_DEG * DEG_TO_RAD * 0.5f;
+    track.search_side = -track.search_side;
+    break;
+
+  default: {
+    int16_t spin_speed = (track.last_direction >= 0) ? track_config.min_speed
+                                                     : -track_config.min_speed;
+    Motor_Output_Set_LR(-spin_speed, spin_speed); // 朝最后的转向方向旋转
+    break;
+  }
+  }
 }
 
 // 更新巡线控制
@@ -52,62 +368,80 @@ void Track_Update(void) {
   if (!track.is_running)
     return;
 
-  // 获取最新CCD数据
-  Deal_Data_CCD();
+  // CCD数据已由模式管理器在本周期采集
 
   // 丢线检测
   if (ccd.line_width == 0) {
-    track.lost_line_count++;
-    if (track.lost_line_count > LINE_LOST_THRESHOLD) {
-      // 丢线处理：使用最小速度进行寻线
-      int16_t search_speed = track.last_direction * MIN_SPEED;
-
-      // 设置电机速度 (M1M2为左轮)
-      Motor_Set_Pwm(MOTOR_ID_M1, search_speed);  // 左前轮
-      Motor_Set_Pwm(MOTOR_ID_M2, search_speed);  // 左后轮
-      Motor_Set_Pwm(MOTOR_ID_M3, -search_speed); // 右前轮
-      Motor_Set_Pwm(MOTOR_ID_M4, -search_speed); // 右后轮
+    if (track.lost_line_count < 255)
+      track.lost_line_count++;
+    track.integral = 0.0f;
+    if (track.lost_line_count > track_config.lost_threshold) {
+      // 丢线处理：按记录的线位置规划找线
+      if (track.recover == RECOVER_NONE)
+        Start_Recovery();
+      Recover_Step();
       return;
     }
   } else {
     track.lost_line_count = 0;
+    track.recover = RECOVER_NONE;
+    Record_Line_Point();
   }
 
   // 计算偏差 (线在左边时CCD_median > 64，需要向左转)
   float error = CCD_median - 64;
 
-  // 根据偏差调整基础速度
-  int16_t adjusted_speed = Adjust_Speed(ccd.line_width, error);
+  // 参数经串口修改后重建控制曲线
+  if (memcmp(&table.config, &track_config, sizeof(track_config)) != 0)
+    Build_Table();
+  uint8_t index = (CCD_median < 128) ? CCD_median : 127;
 
-  // 计算转向量（简单的比例控制）
-  float turn_ratio = error / 64.0f; // 归一化转向比例
-  int16_t turn = (int16_t)(adjusted_speed * turn_ratio);
+  // 根据偏差调整基础速度（查表）
+  int16_t adjusted_speed = table.speed[index];
+
+  // 计算转向量（PID），按当前速度与基础速度之比缩放，低速时转向同步减小
+  // 选用纯追踪且有里程计和线位置记录时改用纯追踪（目标点太近时仍用PID）
+  int16_t turn;
+  bool pursuit = track_config.steer_mode == STEER_PURSUIT &&
+                 track.odom_valid && track.history_count >= 2 &&
+                 Pursuit_Turn(adjusted_speed, &turn);
+  if (!pursuit) {
+    track.integral += error;
+    if (track.integral > PID_INTEGRAL_LIMIT)
+      track.integral = PID_INTEGRAL_LIMIT;
+    if (track.integral < -PID_INTEGRAL_LIMIT)
+      track.integral = -PID_INTEGRAL_LIMIT;
+    float pid = table.p_term[index] + track_config.ki * track.integral +
+                track_config.kd * (error - track.last_error);
+    turn = (int16_t)(pid * table.turn_scale[index]);
+  }
+  track.last_error = error;
 
   // 限制转向输出
-  turn = limit_value(turn, -MAX_SPEED_DIFF, MAX_SPEED_DIFF);
+  turn = limit_value(turn, -track_config.max_speed_diff,
+                     track_config.max_speed_diff);
 
   // 计算左右电机速度
   int16_t left_speed = adjusted_speed - turn;
   int16_t right_speed = adjusted_speed + turn;
 
   // 确保最小速度
-  left_speed = limit_value(left_speed, MIN_SPEED, MAX_SPEED);
-  right_speed = limit_value(right_speed, MIN_SPEED, MAX_SPEED);
+  left_speed = limit_value(left_speed, track_config.min_speed,
+                           track_config.max_speed);
+  right_speed = limit_value(right_speed, track_config.min_speed,
+                            track_config.max_speed);
 
   // 记录转向方向
   track.last_direction = (turn > 0) ? 1 : -1;
 
   // 设置电机速度
-  Motor_Set_Pwm(MOTOR_ID_M1, left_speed);
-  Motor_Set_Pwm(MOTOR_ID_M2, left_speed);
-  Motor_Set_Pwm(MOTOR_ID_M3, right_speed);
-  Motor_Set_Pwm(MOTOR_ID_M4, right_speed);
+  Motor_Output_Set_LR(left_speed, right_speed);
 }
 
 // 停止巡线
 void Track_Stop(void) {
   track.is_running = false;
-  Motor_Stop(1); // 1表示刹车
+  Motor_Output_Stop(1); // 1表示刹车
 }
 
 // 重置巡线状态
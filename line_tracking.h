@@ -3,31 +3,81 @@
 
 #include "bsp_ccd.h"
 #include "bsp_motor.h"
+#include "motor_output.h"
+#include "odometry.h"
 
 // 基础速度参数
 #define BASE_SPEED 800
 #define MAX_SPEED 1000
 #define MIN_SPEED 300
 #define MAX_SPEED_DIFF 200
-#define LINE_LOST_THRESHOLD 50 // 丢线计数阈值
 
-// PID参数
+// PID参数（由 host/gain_opt 在仿真赛道上选出）
 #define PID_KP 12.0f
 #define PID_KI 0.15f
 #define PID_KD 3.0f
+#define PID_INTEGRAL_LIMIT 500.0f // 积分限幅（偏差累加值）
 
 // 动态速度控制参数
 #define NORMAL_LINE_WIDTH 12
 #define SPEED_REDUCE_RATIO 0.7f
 
 // 丢线检测参数
-#define LINE_LOST_THRESHOLD 20
+#define LINE_LOST_THRESHOLD 20 // 连续丢线帧数超过该值后开始找线
 #define SEARCH_SPEED 800
 
+// 轨迹记忆找线参数（需要 Track_Update_Odometry 提供编码器读数）
+#define TRACK_CCD_LOOKAHEAD_CM 20.0f     // CCD视线中心到车体中心的距离
+#define TRACK_CCD_CM_PER_PIXEL 0.164f    // 每像素对应的横向宽度
+#define TRACK_HISTORY_SIZE 8             // 线位置记录条数
+#define TRACK_HISTORY_STEP_CM 2.0f       // 记录间隔（行驶距离）
+#define TRACK_EXTEND_CM 30.0f            // 沿线的走向外推前进的最大距离
+#define TRACK_EDGE_EXIT_PX 48            // 丢线前中线偏离中心的侧向出界距离
+#define TRACK_RETURN_TOLERANCE_CM 3.0f   // 倒车回到记录位姿的位置容差
+#define TRACK_PIVOT_ANGLE_DEG 45.0f      // 朝向偏差超过该值时原地转向
+#define TRACK_HEADING_TOLERANCE_DEG 3.0f // 转到目标朝向的判定容差
+#define TRACK_SEARCH_START_DEG 15.0f     // 扫描初始半角
+#define TRACK_SEARCH_WIDEN_DEG 15.0f     // 每次换向扫描半角的增加量
+#define TRACK_SEARCH_MAX_DEG 120.0f      // 超过后改为原地旋转找线
+#define TRACK_RECOVER_MAX_FRAMES 600     // 找线超时帧数，超时后原地旋转
+
+// 转向律
+#define STEER_PID 0     // 按本帧中线偏差的PID
+#define STEER_PURSUIT 1 // 按线位置记录构成的局部路径做纯追踪
+#define STEER_MODE_DEFAULT STEER_PID
+
+// 纯追踪参数：前视距离随速度在上下限之间线性变化
+#define PURSUIT_LOOKAHEAD_MIN_CM 14.0f // 零速时的前视距离
+#define PURSUIT_LOOKAHEAD_MAX_CM 26.0f // 最大速度时的前视距离
+#define PURSUIT_GAIN 1.2f              // 曲率到差速的增益（1为运动学值）
+#define PURSUIT_MIN_DISTANCE_CM 1.0f   // 目标点近于该距离时改用PID
+
+// 运行时可调参数（默认值取上面的宏，可经串口修改，见 param_table.c）
+typedef struct {
+  int16_t base_speed;
+  int16_t max_speed;
+  int16_t min_speed;
+  int16_t max_speed_diff;
+  uint8_t lost_threshold;
+  float kp;
+  float ki;
+  float kd;
+  float speed_reduce_ratio; // 偏差归一化后每单位的降速比例
+  uint8_t steer_mode;       // STEER_PID / STEER_PURSUIT
+  float lookahead_min;      // 纯追踪前视距离下限 (cm)
+  float lookahead_max;      // 纯追踪前视距离上限 (cm)
+  float pursuit_gain;
+} Track_Config;
+
+extern Track_Config track_config;
+
 // 函数声明
 void Track_Init(void);
 void Track_Update(void);
+void Track_Update_Odometry(int32_t left_count, int32_t right_count);
 void Track_Stop(void);
 void Track_Reset(void);
+uint8_t Track_Recover_Stage(void);
+bool Track_Searching(void);
 
 #endif
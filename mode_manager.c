@@ -0,0 +1,322 @@
+#include "mode_manager.h"
+#include "black_box.h"
+#include "param_link.h"
+#include "wheel_speed.h"
+
+static void Idle_Init(void);
+static void Idle_Step(void);
+
+// 空闲/选择模式：停车，按键选择要进入的模式
+static const Mode_Desc Mode_Idle = {"Idle",    0,    Idle_Init,
+                                    Idle_Step, NULL, MODE_IDLE_PERIOD_MS};
+
+// 模式调度表，下标即串口切换命令中的编号
+static const Mode_Desc *const mode_table[] = {
+    &Mode_Idle,     &Mode_Track, &Mode_CCD_View,    &Mode_Straight,
+    &Mode_Turn,     &Mode_Range, &Mode_Follow_Avoid,
+};
+
+#define MODE_COUNT (sizeof(mode_table) / sizeof(mode_table[0]))
+
+Sensor_Data sensor_data = {0};
+Sensor_Snapshot encoder_channel; // 静态清零即为“尚无数据”
+Sensor_Snapshot range_channel;
+static Wheel_Speed wheel_speed[4];
+
+static uint8_t current_index = 0;
+static uint8_t pending_index = 0;
+static uint8_t menu_index = 1;
+
+// 低功耗统计：用DWT周期计数只累计醒着的时间，休眠期间不计
+typedef struct {
+  uint32_t start_tick;   // 进入低功耗模式的时刻
+  uint64_t awake_cycles; // 醒着的周期数
+  uint32_t wake_cycle;   // 最近一次被唤醒时的周期计数
+  uint32_t switch_cycle; // 触发切换到全速模式的那次唤醒
+  bool report;           // 等全速模式第一个周期结束后输出统计
+} Idle_Stats;
+
+static Idle_Stats idle_stats;
+static uint32_t last_step_tick = 0;
+static uint32_t record_tick = 0;   // 上一条黑匣子记录的时刻
+static bool record_restart = true; // 切换模式后尚未记录
+static uint32_t ping_tick = 0;     // 上一次阻塞测距的时刻
+
+// 刷新选择菜单
+static void Idle_Show_Menu(void) {
+  char line[24];
+  OLED_Clear();
+  OLED_Draw_Line("Mode Select", 0, true, false);
+  snprintf(line, sizeof(line), "> %d %s", menu_index,
+           mode_table[menu_index]->name);
+  OLED_Draw_Line(line, 2, false, false);
+  OLED_Draw_Line("K2/K3:Sel K1:Run", 3, false, true);
+}
+
+static void Idle_Init(void) {
+  Motor_Output_Stop(1);
+  Idle_Show_Menu();
+}
+
+// Key2/Key3选择，Key1进入
+static void Idle_Step(void) {
+  if (Key2_State(1)) {
+    menu_index = (menu_index + 1 < MODE_COUNT) ? menu_index + 1 : 1;
+    Idle_Show_Menu();
+  }
+  if (Key3_State(1)) {
+    menu_index = (menu_index > 1) ? menu_index - 1 : MODE_COUNT - 1;
+    Idle_Show_Menu();
+  }
+  if (Key1_State(1)) {
+    Mode_Manager_Request(menu_index);
+  }
+}
+
+// 采样当前模式需要的传感器
+static void Sample_Sensors(const Mode_Desc *mode) {
+  uint8_t sensors = mode->sensors;
+  uint16_t ping_ms = mode->ping_ms ? mode->ping_ms : RANGE_PING_INTERVAL_MS;
+  sensor_data.tick = HAL_GetTick();
+
+  if (sensors & SENSOR_CCD) {
+    Deal_Data_CCD();
+  }
+  // 编码器和超声波优先取中断发布的最新样本，没有发布者时在这里读取
+  if (sensors & SENSOR_ENCODER) {
+    Encoder_Sample sample;
+    if (Sensor_Snapshot_Read(&encoder_channel, &sample, sizeof(sample))) {
+      memcpy(sensor_data.encoder, sample.count, sizeof(sample.count));
+      sensor_data.encoder_tick = sample.tick;
+    } else {
+      // 没有输入捕获时以读到计数变化的时刻代替边沿时刻（精度为1ms）
+      static uint32_t poll_edge_us[4];
+      sample.time_us = sensor_data.tick * 1000;
+      Encoder_Update_Count();
+      for (uint8_t i = 0; i < 4; i++) {
+        int32_t count = Encoder_Get_Count_Now(MOTOR_ID_M1 + i);
+        if (count != sensor_data.encoder[i])
+          poll_edge_us[i] = sample.time_us;
+        sensor_data.encoder[i] = count;
+        sample.edge_us[i] = poll_edge_us[i];
+      }
+      sensor_data.encoder_tick = sensor_data.tick;
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+      Wheel_Speed_Update(&wheel_speed[i], sensor_data.encoder[i],
+                         sample.edge_us[i], sample.time_us);
+      sensor_data.wheel_speed[i] = Wheel_Speed_Cm_S(&wheel_speed[i]);
+    }
+  }
+  if (sensors & SENSOR_ULTRASONIC) {
+    Range_Sample sample;
+    if (Sensor_Snapshot_Read(&range_channel, &sample, sizeof(sample))) {
+      sensor_data.distance = sample.distance;
+      sensor_data.distance_tick = sample.tick;
+    } else if (sensor_data.tick - ping_tick >= ping_ms) {
+      ping_tick = sensor_data.tick;
+      sensor_data.distance = Get_distance();
+      sensor_data.distance_tick = sensor_data.tick;
+    }
+  }
+  if (sensors & SENSOR_IR) {
+    Get_Iravoid_Data(&sensor_data.ir_left, &sensor_data.ir_right);
+  }
+  // 视觉结果由接收中断发布，读取被打断时保留上一次的结果
+  if (sensors & SENSOR_VISION) {
+    Sensor_Snapshot_Read(&vision_line_channel, &sensor_data.vision_line,
+                         sizeof(sensor_data.vision_line));
+    Sensor_Snapshot_Read(&vision_object_channel, &sensor_data.vision_object,
+                         sizeof(sensor_data.vision_object));
+    // 超过VISION_STALE_MS未更新视为相机失效：置信度清零，按未检出处理
+    if (sensor_data.tick - sensor_data.vision_line.tick > VISION_STALE_MS)
+      sensor_data.vision_line.confidence = 0;
+    if (sensor_data.tick - sensor_data.vision_object.tick > VISION_STALE_MS)
+      sensor_data.vision_object.confidence = 0;
+  }
+}
+
+// 全速模式下每个周期向黑匣子写一条记录，周期超时时触发冻结
+static void Record_Cycle(void) {
+  uint32_t now = HAL_GetTick();
+  uint32_t loop_ms = now - record_tick;
+  record_tick = now;
+
+  const int32_t *count = sensor_data.encoder;
+  const int16_t *pwm = Motor_Output_Get();
+  Black_Box_Record record = {
+      .tick = (uint16_t)now,
+      .mode = current_index,
+      .stage = Track_Recover_Stage(),
+      .median = CCD_median,
+      .width = ccd.line_width,
+      .exposure = ccd.exposure_time,
+      .loop_ms = (loop_ms < 255) ? loop_ms : 255,
+      .count = {(int16_t)((count[MOTOR_ID_M1] + count[MOTOR_ID_M2]) / 2),
+                (int16_t)((count[MOTOR_ID_M3] + count[MOTOR_ID_M4]) / 2)},
+      .pwm = {pwm[0], pwm[1], pwm[2], pwm[3]},
+  };
+  Black_Box_Record_Cycle(&record);
+
+  // 切换模式后的第一个周期包含模式初始化（从低功耗模式回来时还包含
+  // 整段空闲时间），不算超时
+  if (loop_ms > BLACK_BOX_OVERRUN_MS && !record_restart)
+    Black_Box_Trigger(BLACK_BOX_OVERRUN);
+  record_restart = false;
+}
+
+// 检查切换请求：串口数字命令（调参帧之外的字节）、视觉协处理器的二维码指令，
+// 或任意模式下同时按住Key1和Key3返回选择菜单
+static void Poll_Switch_Request(void) {
+  int16_t byte = Param_Link_Poll();
+  if (byte >= '0' && byte <= '9') {
+    Mode_Manager_Request(byte - '0');
+  }
+
+  Sensor_Event event;
+  while (Sensor_Ring_Pop(&vision_command_ring, &event)) {
+    if (event.flags == VISION_CMD_MODE) {
+      // 参数是16位的，先检查范围再转成编号，避免257等值截断成有效模式
+      if (event.value >= 0 && event.value < Mode_Manager_Count())
+        Mode_Manager_Request((uint8_t)event.value);
+    } else if (event.flags == VISION_CMD_STOP) {
+      Mode_Manager_Request(0);
+    }
+  }
+
+  if (current_index != 0 && Key1_State(0) && Key3_State(0)) {
+    Black_Box_Trigger(BLACK_BOX_KEY);
+    Mode_Manager_Request(0);
+  }
+}
+
+// 开始统计低功耗模式的占空比
+static void Idle_Stats_Start(void) {
+  idle_stats.start_tick = HAL_GetTick();
+  idle_stats.awake_cycles = 0;
+  idle_stats.wake_cycle = DWT->CYCCNT;
+}
+
+// 离开低功耗模式进入全速模式后的第一个周期结束时调用：
+// 输出低功耗期间的占空比，以及从唤醒到新模式跑完第一个周期的延迟
+static void Idle_Stats_Report(void) {
+  uint32_t now = DWT->CYCCNT;
+  uint32_t cycles_per_ms = SystemCoreClock / 1000;
+  uint32_t elapsed_ms = HAL_GetTick() - idle_stats.start_tick;
+  uint64_t awake = idle_stats.awake_cycles + (now - idle_stats.wake_cycle);
+  float duty = elapsed_ms ? 100.0f * awake / cycles_per_ms / elapsed_ms : 0;
+
+  printf("Idle %lu ms, duty %.1f%%, wake latency %lu us\r\n",
+         (unsigned long)elapsed_ms, duty,
+         (unsigned long)((now - idle_stats.switch_cycle) /
+                         (cycles_per_ms / 1000)));
+  idle_stats.report = false;
+}
+
+// 执行模式切换：先退出旧模式并停车，再进入新模式
+static void Switch_Mode(uint8_t index) {
+  const Mode_Desc *old_mode = mode_table[current_index];
+  if (old_mode->exit != NULL)
+    old_mode->exit();
+  Motor_Output_Stop(1);
+  if (old_mode->period_ms == 0)
+    Black_Box_Freeze(); // 中止或丢线后停车：触发后的记录到此为止
+  if (index == 0)
+    Black_Box_Save(); // 停车后才写Flash
+  record_restart = true;
+
+  // 从低功耗进入全速模式：记下唤醒时刻，新模式第一个周期后输出统计
+  if (old_mode->period_ms != 0 && mode_table[index]->period_ms == 0) {
+    idle_stats.switch_cycle = idle_stats.wake_cycle;
+    idle_stats.report = true;
+  } else if (mode_table[index]->period_ms != 0) {
+    Idle_Stats_Start();
+  }
+
+  current_index = index;
+  OLED_Clear();
+  printf("\r\nMode %d: %s\r\n", index, mode_table[index]->name);
+
+  // 进入前先采样一次，使init看到有效的传感器数据
+  Sample_Sensors(mode_table[index]);
+  if (mode_table[index]->init != NULL)
+    mode_table[index]->init();
+}
+
+// 初始化：进入空闲模式
+void Mode_Manager_Init(void) {
+  current_index = 0;
+  pending_index = 0;
+
+  // 打开DWT周期计数（低功耗统计用）
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  Idle_Stats_Start();
+
+  printf("\r\nModes:");
+  for (uint8_t i = 0; i < MODE_COUNT; i++) {
+    printf(" %d:%s", i, mode_table[i]->name);
+  }
+  printf("\r\n");
+  Mode_Idle.init();
+}
+
+// 主循环调用：处理切换请求，采样传感器，执行当前模式
+void Mode_Manager_Step(void) {
+  Poll_Switch_Request();
+  if (pending_index != current_index) {
+    Switch_Mode(pending_index);
+  }
+
+  const Mode_Desc *mode = mode_table[current_index];
+  last_step_tick = HAL_GetTick();
+
+  // 低速采样时两帧间隔远大于曝光时间，CCD会饱和：先读一次清空，
+  // 积分接近全速时的帧间隔后再正式采样
+  if (mode->period_ms != 0 && (mode->sensors & SENSOR_CCD)) {
+    RD_TSL();
+    HAL_Delay(MODE_CCD_FLUSH_MS);
+  }
+  Sample_Sensors(mode);
+  mode->step();
+  Motor_Output_Tick(); // 电机输出按变化率限制逼近本周期设置的目标
+  if (mode->sensors & SENSOR_CCD) {
+    CCD_Stream_Frame(); // 遥测打开时发送本帧（含本周期的检测结果）
+  }
+
+  if (mode->period_ms == 0)
+    Record_Cycle();
+
+  if (idle_stats.report)
+    Idle_Stats_Report();
+}
+
+// 主循环在两次Mode_Manager_Step之间调用：全速模式保持1ms间隔；
+// 低功耗模式休眠到下一个周期，每次SysTick醒来只做一次比较，
+// 串口收到数据（调参或切换命令）时立即返回
+void Mode_Manager_Wait(void) {
+  const Mode_Desc *mode = mode_table[current_index];
+  if (mode->period_ms == 0 || pending_index != current_index) {
+    HAL_Delay(1);
+    return;
+  }
+
+  while ((uint32_t)(HAL_GetTick() - last_step_tick) < mode->period_ms &&
+         !Param_Link_Rx_Pending()) {
+    idle_stats.awake_cycles += DWT->CYCCNT - idle_stats.wake_cycle;
+    HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+    idle_stats.wake_cycle = DWT->CYCCNT;
+  }
+}
+
+// 请求切换模式（下一次Mode_Manager_Step时生效）
+bool Mode_Manager_Request(uint8_t index) {
+  if (index >= MODE_COUNT)
+    return false;
+  pending_index = index;
+  return true;
+}
+
+uint8_t Mode_Manager_Current(void) { return current_index; }
+
+uint8_t Mode_Manager_Count(void) { return MODE_COUNT; }
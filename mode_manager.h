@@ -0,0 +1,106 @@
+#ifndef __MODE_MANAGER_H
+#define __MODE_MANAGER_H
+
+#include "bsp.h"
+#include "sensor_channel.h"
+#include "vision_link.h"
+
+// 运行模式管理：各功能以初始化/单步/退出钩子注册到调度表，
+// 运行时通过按键或串口切换，只采样当前模式声明需要的传感器
+
+// 传感器需求标志
+#define SENSOR_CCD (1 << 0)
+#define SENSOR_ENCODER (1 << 1)
+#define SENSOR_ULTRASONIC (1 << 2)
+#define SENSOR_IR (1 << 3)
+#define SENSOR_VISION (1 << 4) // 视觉协处理器的巡线和识别结果
+
+// 低功耗周期：停车和显示类模式不需要每毫秒运行，
+// 两次运行之间WFI休眠（SysTick、串口接收中断唤醒）
+#define MODE_IDLE_PERIOD_MS 20     // 选择菜单的按键轮询周期
+#define MODE_DISPLAY_PERIOD_MS 100 // CCD显示模式的采样和刷新周期
+#define MODE_CCD_FLUSH_MS 2         // 低速采样时清空CCD后的积分时间
+
+// 模式描述
+typedef struct {
+  const char *name;
+  uint8_t sensors;    // 需要采样的传感器（SENSOR_*按位或）
+  void (*init)(void); // 进入模式
+  void (*step)(void); // 每个循环调用一次
+  void (*exit)(void); // 离开模式
+  uint16_t period_ms; // 非0时为低功耗模式，每隔该时间运行一次
+  uint16_t ping_ms;   // 阻塞测距的最小间隔，0为RANGE_PING_INTERVAL_MS
+} Mode_Desc;
+
+// 本周期的传感器采样结果（仅包含当前模式声明的传感器）
+typedef struct {
+  uint32_t tick;
+  float distance;         // 超声波原始距离 (cm)
+  uint16_t ir_left;       // 左IR
+  uint16_t ir_right;      // 右IR
+  int32_t encoder[4];     // 四轮编码器累计值
+  uint32_t distance_tick; // 距离的采样时刻（中断发布时早于tick，不变即无新值）
+  uint32_t encoder_tick;  // 编码器的采样时刻
+  float wheel_speed[4];   // 四轮速度 (cm/s)，M/T法
+  Vision_Line vision_line;     // 视觉巡线结果（tick为0表示尚未收到）
+  Vision_Object vision_object; // 视觉识别结果
+} Sensor_Data;
+
+extern Sensor_Data sensor_data;
+
+// 中断发布的传感器样本：板级定时器中断读编码器、超声回波中断算出距离后
+// 用 Sensor_Snapshot_Write 写入对应快照；发布过的传感器不再在主循环中阻塞读取
+// 编码器样本同时带上各轮最近一个边沿的输入捕获时刻，用于M/T法测速
+typedef struct {
+  uint32_t tick;
+  int32_t count[4];
+  uint32_t time_us;    // 读计数的时刻 (us)
+  uint32_t edge_us[4]; // 产生当前计数的边沿时刻 (us)
+} Encoder_Sample;
+
+typedef struct {
+  uint32_t tick;
+  float distance; // (cm)
+} Range_Sample;
+
+// 没有中断发布距离时主循环阻塞测距，两次发射至少间隔该时间（模式可在
+// Mode_Desc.ping_ms 中另行指定），否则会收到上一次发射的余波
+#define RANGE_PING_INTERVAL_MS 60
+
+extern Sensor_Snapshot encoder_channel;
+extern Sensor_Snapshot range_channel;
+
+// 各功能模式（定义在对应的源文件中）
+extern const Mode_Desc Mode_Track;
+extern const Mode_Desc Mode_CCD_View;
+extern const Mode_Desc Mode_Straight;
+extern const Mode_Desc Mode_Turn;
+extern const Mode_Desc Mode_Range;
+extern const Mode_Desc Mode_Follow_Avoid;
+
+// 跟随避障模式的可调参数（定义在超声跟随避障.c，可经串口修改）
+typedef struct {
+  float stop_distance; // 停止距离 (cm)
+  float max_distance;  // 最大跟随距离 (cm)
+  float lost_distance; // 跟随中拉开到该距离才视为丢失 (cm)
+  float base_distance; // 目标间距 (cm)
+  int16_t base_speed;
+  int16_t max_speed;
+  int16_t turn_speed;
+  int16_t min_speed;
+  uint16_t ir_threshold; // IR转向阈值
+  int16_t avoid_turn_gain;
+  int16_t avoid_max_turn;
+} Follow_Avoid_Config;
+
+extern Follow_Avoid_Config follow_avoid_config;
+
+// 函数声明
+void Mode_Manager_Init(void);
+void Mode_Manager_Step(void);
+void Mode_Manager_Wait(void);
+bool Mode_Manager_Request(uint8_t index);
+uint8_t Mode_Manager_Current(void);
+uint8_t Mode_Manager_Count(void);
+
+#endif
@@ -0,0 +1,121 @@
+#include "motor_output.h"
+
+static int16_t motor_target[4] = {0}; // 设置函数给出的目标
+static int16_t motor_output[4] = {0}; // 已写入定时器的输出
+static uint32_t last_tick_ms = 0;
+
+// 单路变化率限制：同向减速立即生效，加速按步长逼近；
+// 反向时先按反向步长减到0（本周期停在0），再从0开始加速
+static int16_t Slew_Limit(int16_t current, int16_t target, int32_t step,
+                          int32_t reverse_step) {
+  if ((current > 0 && target < 0) || (current < 0 && target > 0)) {
+    if (ABS(current) <= reverse_step)
+      return 0;
+    return (int16_t)((current > 0) ? current - reverse_step
+                                   : current + reverse_step);
+  }
+
+  // 目标更接近0（减速），直接生效
+  if (ABS(target) <= ABS(current))
+    return target;
+
+  int32_t delta = target - current;
+  if (delta > step)
+    delta = step;
+  if (delta < -step)
+    delta = -step;
+  return (int16_t)(current + delta);
+}
+
+// 各路输出是否都已到达目标
+static bool Settled(void) {
+  for (int i = 0; i < 4; i++) {
+    if (motor_output[i] != motor_target[i])
+      return false;
+  }
+  return true;
+}
+
+// 写入四路比较寄存器：定义了PWM定时器时期间屏蔽更新事件，预装载值在各
+// 定时器的下一个更新事件一起生效，不会出现同一侧只换了一路的PWM周期
+static void Commit_Outputs(void) {
+#ifdef MOTOR_PWM_TIM_A
+  MOTOR_PWM_TIM_A->CR1 |= TIM_CR1_UDIS;
+  MOTOR_PWM_TIM_B->CR1 |= TIM_CR1_UDIS;
+#endif
+
+  Motor_Set_Pwm(MOTOR_ID_M1, motor_output[0]); // 左前
+  Motor_Set_Pwm(MOTOR_ID_M2, motor_output[1]); // 左后
+  Motor_Set_Pwm(MOTOR_ID_M3, motor_output[2]); // 右前
+  Motor_Set_Pwm(MOTOR_ID_M4, motor_output[3]); // 右后
+
+#ifdef MOTOR_PWM_TIM_A
+  MOTOR_PWM_TIM_A->CR1 &= ~TIM_CR1_UDIS;
+  MOTOR_PWM_TIM_B->CR1 &= ~TIM_CR1_UDIS;
+#endif
+}
+
+// 初始化：输出清零
+void Motor_Output_Init(void) {
+  for (int i = 0; i < 4; i++) {
+    motor_target[i] = 0;
+    motor_output[i] = 0;
+  }
+  last_tick_ms = HAL_GetTick();
+  Commit_Outputs();
+}
+
+// 批量设置四路目标：同向减速立即生效，加速和反向由Motor_Output_Tick推进
+void Motor_Output_Set(int16_t m1, int16_t m2, int16_t m3, int16_t m4) {
+  // 静止（已到达目标）期间不计时，从这次设置开始计算变化量
+  if (Settled())
+    last_tick_ms = HAL_GetTick();
+
+  motor_target[0] = m1;
+  motor_target[1] = m2;
+  motor_target[2] = m3;
+  motor_target[3] = m4;
+  Motor_Output_Tick();
+}
+
+// 按左右两侧设置输出（M1M2为左轮，M3M4为右轮）
+void Motor_Output_Set_LR(int16_t left, int16_t right) {
+  Motor_Output_Set(left, left, right, right);
+}
+
+// 每个主循环周期调用：按距上次调用的时间把输出推向目标，
+// 已到达目标时不写寄存器
+void Motor_Output_Tick(void) {
+  uint32_t now = HAL_GetTick();
+  uint32_t dt = now - last_tick_ms;
+  last_tick_ms = now;
+
+  if (Settled())
+    return;
+  if (dt > MOTOR_SLEW_MAX_DT_MS)
+    dt = MOTOR_SLEW_MAX_DT_MS;
+  int32_t step = MOTOR_SLEW_PER_MS * (int32_t)dt;
+  int32_t reverse_step = MOTOR_REVERSE_SLEW_PER_MS * (int32_t)dt;
+
+  bool changed = false;
+  for (int i = 0; i < 4; i++) {
+    int16_t value =
+        Slew_Limit(motor_output[i], motor_target[i], step, reverse_step);
+    changed = changed || value != motor_output[i];
+    motor_output[i] = value;
+  }
+  if (changed)
+    Commit_Outputs();
+}
+
+// 立即停止（不经变化率限制），brake为1时刹车
+void Motor_Output_Stop(uint8_t brake) {
+  for (int i = 0; i < 4; i++) {
+    motor_target[i] = 0;
+    motor_output[i] = 0;
+  }
+  Motor_Stop(brake);
+}
+
+// 当前实际输出（经变化率限制后的值）
+const int16_t *Motor_Output_Get(void) { return motor_output; }
@@ -0,0 +1,31 @@
+#ifndef __MOTOR_OUTPUT_H
+#define __MOTOR_OUTPUT_H
+
+#include "bsp.h"
+
+// 四轮电机输出：一次写入四路占空比，并对每路做变化率限制
+// 设置函数只记下各路目标，由 Motor_Output_Tick（每个主循环周期调用）
+// 按经过的时间把实际输出逐步推向目标，只调用一次设置也不会越过限制
+// 定义了PWM所在定时器时，两个定时器各自在自己的更新事件装载：同一侧的
+// 两路一起生效，左右两侧可能相差不到一个PWM周期（没有做主从同步）
+
+// 电机PWM所在定时器：电机驱动配置（bsp_motor.c）不在本仓库中，下面是按接线
+// 推定的，未经核对。对照CubeMX配置确认后取消注释；未定义时逐路直接写入，
+// 同一侧的两路可能在相邻的PWM周期先后生效
+// #define MOTOR_PWM_TIM_A TIM8 // M1、M2
+// #define MOTOR_PWM_TIM_B TIM1 // M3、M4
+
+// 变化率限制：远离0（加速）时每毫秒最大变化量，同向减速时不限制
+#define MOTOR_SLEW_PER_MS 25         // 0到1000约40ms
+#define MOTOR_REVERSE_SLEW_PER_MS 50 // 反向时先减到0，1000到0约20ms
+#define MOTOR_SLEW_MAX_DT_MS 10      // 主循环停顿时单次最多按该时间推进
+
+// 函数声明
+void Motor_Output_Init(void);
+void Motor_Output_Set(int16_t m1, int16_t m2, int16_t m3, int16_t m4);
+void Motor_Output_Set_LR(int16_t left, int16_t right);
+void Motor_Output_Tick(void);
+void Motor_Output_Stop(uint8_t brake);
+const int16_t *Motor_Output_Get(void);
+
+#endif
@@ -0,0 +1,97 @@
+#include "obstacle_map.h"
+#include <math.h>
+
+#define OBST_TWO_PI 6.2831853f
+
+// 世界坐标角度对应的扇区下标
+// 扇区以中心角划分，第OBST_SECTORS/2扇区以0为中心、覆盖正负半个扇区，
+// 航向0附近的小抖动不会在两个扇区之间来回跳
+static uint8_t Angle_To_Sector(float angle) {
+  int32_t index = (int32_t)floorf(angle / OBST_TWO_PI * OBST_SECTORS + 0.5f) +
+                  OBST_SECTORS / 2;
+  return (uint8_t)((index % OBST_SECTORS + OBST_SECTORS) % OBST_SECTORS);
+}
+
+static uint8_t Wrap_Sector(int16_t index) {
+  return (uint8_t)((index % OBST_SECTORS + OBST_SECTORS) % OBST_SECTORS);
+}
+
+static void Sector_Hit(Obstacle_Map *map, uint8_t sector, uint8_t amount) {
+  uint16_t value = map->certainty[sector] + amount;
+  map->certainty[sector] = (value > 255) ? 255 : value;
+}
+
+static void Sector_Free(Obstacle_Map *map, uint8_t sector) {
+  map->certainty[sector] = (map->certainty[sector] > OBST_FREE)
+                               ? map->certainty[sector] - OBST_FREE
+                               : 0;
+}
+
+// 扇区及其两侧加权的障碍密度，使车身宽度附近的方向也被视为占用
+static uint16_t Smoothed_Density(const Obstacle_Map *map, uint8_t sector) {
+  return map->certainty[Wrap_Sector(sector - 1)] +
+         2 * map->certainty[sector] + map->certainty[Wrap_Sector(sector + 1)];
+}
+
+// 初始化直方图
+void Obstacle_Map_Init(Obstacle_Map *map) {
+  for (int i = 0; i < OBST_SECTORS; i++) {
+    map->certainty[i] = 0;
+  }
+}
+
+// 用当前航向下的超声波和左右IR读数更新直方图
+void Obstacle_Map_Update(Obstacle_Map *map, float heading, float distance,
+                         uint16_t left_ir, uint16_t right_ir) {
+  // 整体衰减，旧障碍逐渐遗忘
+  for (int i = 0; i < OBST_SECTORS; i++) {
+    map->certainty[i] =
+        (map->certainty[i] > OBST_DECAY) ? map->certainty[i] - OBST_DECAY : 0;
+  }
+
+  // 超声波：正前方，越近置信度增加越多
+  uint8_t front = Angle_To_Sector(heading);
+  if (distance < OBST_ULTRA_RANGE_CM) {
+    float closeness = 1.0f - distance / OBST_ULTRA_RANGE_CM;
+    Sector_Hit(map, front, (uint8_t)(OBST_HIT * (0.5f + closeness)));
+  } else {
+    Sector_Free(map, front);
+  }
+
+  // 左右IR：斜前方
+  uint8_t left = Angle_To_Sector(heading + OBST_IR_BEARING);
+  uint8_t right = Angle_To_Sector(heading - OBST_IR_BEARING);
+  if (left_ir < OBST_IR_THRESHOLD)
+    Sector_Hit(map, left, OBST_HIT);
+  else
+    Sector_Free(map, left);
+  if (right_ir < OBST_IR_THRESHOLD)
+    Sector_Hit(map, right, OBST_HIT);
+  else
+    Sector_Free(map, right);
+}
+
+// 选择可通行且最接近当前航向的方向，固定遍历OBST_SECTORS个扇区
+Obstacle_Steer Obstacle_Map_Select(const Obstacle_Map *map, float heading) {
+  Obstacle_Steer steer = {0, 0, 0, true};
+  uint8_t front = Angle_To_Sector(heading);
+  uint16_t best_cost = UINT16_MAX;
+
+  steer.forward = Smoothed_Density(map, front);
+
+  for (int8_t offset = -OBST_SECTORS / 2 + 1; offset <= OBST_SECTORS / 2;
+       offset++) {
+    uint16_t density = Smoothed_Density(map, Wrap_Sector(front + offset));
+    if (density >= OBST_BLOCK_LEVEL)
+      continue;
+
+    uint16_t cost = density + (offset < 0 ? -offset : offset) * OBST_TURN_COST;
+    if (cost < best_cost) {
+      best_cost = cost;
+      steer.offset = offset;
+      steer.density = density;
+      steer.blocked = false;
+    }
+  }
+  return steer;
+}
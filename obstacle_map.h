@@ -0,0 +1,42 @@
+#ifndef __OBSTACLE_MAP_H
+#define __OBSTACLE_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 以车为中心的极坐标障碍直方图，扇区按世界坐标航向划分，
+// 车身转动后仍记得刚避开的障碍方向
+// 纯算法模块，不依赖HAL，可直接在主机上编译
+
+// 直方图参数
+#define OBST_SECTORS 16      // 扇区数（每扇区22.5度）
+#define OBST_HIT 64          // 检测到障碍时增加的置信度
+#define OBST_FREE 16         // 观测到空闲时减少的置信度
+#define OBST_DECAY 2         // 每次更新所有扇区的衰减量
+#define OBST_BLOCK_LEVEL 320 // 平滑后超过该值的扇区不可通行
+#define OBST_TURN_COST 24    // 每偏离当前航向一个扇区的代价
+
+// 传感器参数
+#define OBST_ULTRA_RANGE_CM 30.0f // 超声波距离小于该值视为障碍
+#define OBST_IR_THRESHOLD 200     // IR读数小于该值视为障碍（数值越小越近）
+#define OBST_IR_BEARING 0.785f    // 左右IR安装方向与正前方夹角 (rad)
+
+// 方向选择结果
+typedef struct {
+  int8_t offset;    // 相对车头的扇区偏移，正值为左
+  uint16_t density; // 所选方向的平滑障碍密度
+  uint16_t forward; // 正前方的平滑障碍密度
+  bool blocked;     // 所有方向都不可通行
+} Obstacle_Steer;
+
+typedef struct {
+  uint8_t certainty[OBST_SECTORS];
+} Obstacle_Map;
+
+// 函数声明
+void Obstacle_Map_Init(Obstacle_Map *map);
+void Obstacle_Map_Update(Obstacle_Map *map, float heading, float distance,
+                         uint16_t left_ir, uint16_t right_ir);
+Obstacle_Steer Obstacle_Map_Select(const Obstacle_Map *map, float heading);
+
+#endif
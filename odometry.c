@@ -0,0 +1,40 @@
+#include "odometry.h"
+#include <math.h>
+
+#define ODOM_PI 3.14159265f
+
+// 将角度归一化到(-pi, pi]
+float Odometry_Wrap_Angle(float angle) {
+  while (angle > ODOM_PI)
+    angle -= 2.0f * ODOM_PI;
+  while (angle <= -ODOM_PI)
+    angle += 2.0f * ODOM_PI;
+  return angle;
+}
+
+// 以当前编码器读数为原点初始化
+void Odometry_Init(Odometry *odom, int32_t left_count, int32_t right_count) {
+  odom->x = 0.0f;
+  odom->y = 0.0f;
+  odom->heading = 0.0f;
+  odom->speed = 0.0f;
+  odom->last_left = left_count;
+  odom->last_right = right_count;
+}
+
+// 用编码器增量推算位姿（中点航向积分）
+void Odometry_Update(Odometry *odom, int32_t left_count, int32_t right_count) {
+  float d_left = (left_count - odom->last_left) / ODOM_ENCODER_PER_CM;
+  float d_right = (right_count - odom->last_right) / ODOM_ENCODER_PER_CM;
+  odom->last_left = left_count;
+  odom->last_right = right_count;
+
+  float d_center = (d_left + d_right) * 0.5f;
+  float d_theta = (d_right - d_left) / ODOM_TRACK_WIDTH_CM;
+  float mid_heading = odom->heading + d_theta * 0.5f;
+
+  odom->x += d_center * cosf(mid_heading);
+  odom->y += d_center * sinf(mid_heading);
+  odom->heading = Odometry_Wrap_Angle(odom->heading + d_theta);
+  odom->speed = d_center;
+}
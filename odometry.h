@@ -0,0 +1,30 @@
+#ifndef __ODOMETRY_H
+#define __ODOMETRY_H
+
+#include <stdint.h>
+
+// 差速里程计：由左右两侧编码器累计值推算位置和航向
+// 纯算法模块，编码器读数由调用者传入，可直接在主机上编译
+
+// 标定参数（与定长直行、直角弯中的实测常数一致）
+#define ODOM_ENCODER_PER_CM 50.0f  // 每厘米编码器计数
+#define ODOM_ENCODER_PER_DEG 25.2f // 原地转向时每度单侧编码器计数
+// 等效轮距：原地转1弧度时单侧走过的弧长的2倍（含打滑的等效值）
+#define ODOM_TRACK_WIDTH_CM                                                    \
+  (2.0f * ODOM_ENCODER_PER_DEG * 57.29578f / ODOM_ENCODER_PER_CM)
+
+typedef struct {
+  float x;       // 前进方向位置 (cm)
+  float y;       // 左侧方向位置 (cm)
+  float heading; // 航向 (rad)，逆时针（左转）为正，范围(-pi, pi]
+  float speed;   // 最近一次更新的前进距离 (cm)
+  int32_t last_left;
+  int32_t last_right;
+} Odometry;
+
+// 函数声明
+void Odometry_Init(Odometry *odom, int32_t left_count, int32_t right_count);
+void Odometry_Update(Odometry *odom, int32_t left_count, int32_t right_count);
+float Odometry_Wrap_Angle(float angle);
+
+#endif
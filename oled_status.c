@@ -0,0 +1,97 @@
+#include "oled_status.h"
+#include "bsp.h"
+
+void Oled_Text_Clear(Oled_Text *t) {
+  t->length = 0;
+  t->text[0] = '\0';
+}
+
+static void Put_Char(Oled_Text *t, char c) {
+  if (t->length < OLED_LINE_CHARS) {
+    t->text[t->length++] = c;
+    t->text[t->length] = '\0';
+  }
+}
+
+void Oled_Text_Str(Oled_Text *t, const char *s) {
+  while (*s != '\0') {
+    Put_Char(t, *s++);
+  }
+}
+
+// 十进制整数
+void Oled_Text_Int(Oled_Text *t, int32_t value) {
+  char digits[10];
+  uint8_t n = 0;
+  uint32_t magnitude = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+
+  if (value < 0)
+    Put_Char(t, '-');
+  do {
+    digits[n++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude != 0);
+  while (n > 0) {
+    Put_Char(t, digits[--n]);
+  }
+}
+
+// 定点小数：按decimals位四舍五入成整数后再拆出整数和小数部分，
+// 只有一次浮点乘法，其余都是整数运算
+void Oled_Text_Fixed(Oled_Text *t, float value, uint8_t decimals) {
+  static const int32_t scale[] = {1, 10, 100, 1000};
+  if (decimals > 3)
+    decimals = 3;
+
+  float scaled = value * scale[decimals];
+  int32_t fixed = (int32_t)(scaled + (scaled < 0 ? -0.5f : 0.5f));
+  uint32_t magnitude = (fixed < 0) ? -(uint32_t)fixed : (uint32_t)fixed;
+
+  if (fixed < 0)
+    Put_Char(t, '-');
+  Oled_Text_Int(t, magnitude / scale[decimals]);
+  if (decimals == 0)
+    return;
+
+  Put_Char(t, '.');
+  uint32_t fraction = magnitude % scale[decimals];
+  for (int32_t digit = scale[decimals] / 10; digit > 0; digit /= 10) {
+    Put_Char(t, '0' + fraction / digit % 10);
+  }
+}
+
+// 清空缓存，下次Flush时重画全部已设置的行
+void Oled_Status_Init(Oled_Status *status, uint8_t title_mask) {
+  memset(status, 0, sizeof(*status));
+  status->title_mask = title_mask;
+}
+
+// 设置一行的内容，与屏上内容相同时不做任何事
+void Oled_Status_Set(Oled_Status *status, uint8_t line, const char *text) {
+  if (line >= OLED_STATUS_LINES)
+    return;
+  char *shown = status->shown[line];
+  if ((status->set & (1u << line)) &&
+      strncmp(shown, text, OLED_LINE_CHARS) == 0)
+    return;
+
+  strncpy(shown, text, OLED_LINE_CHARS);
+  shown[OLED_LINE_CHARS] = '\0';
+  status->set |= 1u << line;
+  status->dirty |= 1u << line;
+}
+
+// 重画变化的行，有变化时刷新一次屏幕；返回是否刷新了屏幕
+bool Oled_Status_Flush(Oled_Status *status) {
+  if (status->dirty == 0)
+    return false;
+
+  for (uint8_t line = 0; line < OLED_STATUS_LINES; line++) {
+    if (status->dirty & (1u << line))
+      OLED_Draw_Line(status->shown[line], line,
+                     (status->title_mask >> line) & 1u, false);
+  }
+  OLED_Refresh();
+  status->dirty = 0;
+  return true;
+}
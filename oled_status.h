@@ -0,0 +1,36 @@
+#ifndef __OLED_STATUS_H
+#define __OLED_STATUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// OLED状态屏：缓存每行已显示的文字，只重画内容变化的行，
+// 没有变化时不刷新屏幕（整屏刷新经I2C传送1KB，是显示的主要耗时）
+// 数值用定点整数格式化，不经过printf的浮点路径
+
+#define OLED_STATUS_LINES 5 // 第0~4行
+#define OLED_LINE_CHARS 21  // 每行最多字符数（超出部分截断）
+
+// 一行文字的拼接缓冲
+typedef struct {
+  char text[OLED_LINE_CHARS + 1];
+  uint8_t length;
+} Oled_Text;
+
+typedef struct {
+  char shown[OLED_STATUS_LINES][OLED_LINE_CHARS + 1]; // 屏上当前的内容
+  uint8_t set;        // 已经设置过内容的行（按位）
+  uint8_t dirty;      // 待重画的行（按位）
+  uint8_t title_mask; // 按标题样式绘制的行（按位）
+} Oled_Status;
+
+// 函数声明
+void Oled_Text_Clear(Oled_Text *t);
+void Oled_Text_Str(Oled_Text *t, const char *s);
+void Oled_Text_Int(Oled_Text *t, int32_t value);
+void Oled_Text_Fixed(Oled_Text *t, float value, uint8_t decimals);
+void Oled_Status_Init(Oled_Status *status, uint8_t title_mask);
+void Oled_Status_Set(Oled_Status *status, uint8_t line, const char *text);
+bool Oled_Status_Flush(Oled_Status *status);
+
+#endif
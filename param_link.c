@@ -0,0 +1,313 @@
+#include "param_link.h"
+#include "black_box.h"
+#include "mode_manager.h"
+#include "param_table.h"
+
+// 接收环形缓冲：中断中写入，主循环中读取（单生产者单消费者）
+static volatile uint8_t rx_buffer[PARAM_LINK_RX_SIZE];
+static volatile uint8_t rx_head = 0;
+static volatile uint8_t rx_tail = 0;
+static uint8_t rx_byte;
+
+// 帧解析状态
+typedef enum {
+  LINK_WAIT_SYNC = 0,
+  LINK_WAIT_CMD,
+  LINK_WAIT_LEN,
+  LINK_PAYLOAD,
+  LINK_WAIT_CRC,
+} Link_State;
+
+static Link_State state = LINK_WAIT_SYNC;
+static uint8_t frame_cmd;
+static uint8_t frame_len;
+static uint8_t frame_pos;
+static uint8_t frame_payload[PARAM_LINK_MAX_PAYLOAD];
+static uint32_t frame_start_ms;
+
+// 应答在中断方式下发送，发完之前不解析新命令
+static uint8_t tx_buffer[PARAM_LINK_MAX_PAYLOAD + 4];
+static uint8_t tx_length = 0;
+
+static uint32_t flash_image[PARAM_IMAGE_MAX_WORDS];
+
+// CRC-8（多项式0x07），可分段累加
+static uint8_t Crc8(uint8_t crc, const uint8_t *data, uint16_t len) {
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// 串口接收完成中断：存入环形缓冲后继续接收下一个字节
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+  if (huart == &huart1) {
+    Param_Link_Rx_Byte(rx_byte);
+    HAL_UART_Receive_IT(&huart1, &rx_byte, 1);
+  }
+}
+
+// 写入一个接收字节（缓冲满时丢弃）
+void Param_Link_Rx_Byte(uint8_t byte) {
+  uint8_t next = (rx_head + 1) & (PARAM_LINK_RX_SIZE - 1);
+  if (next != rx_tail) {
+    rx_buffer[rx_head] = byte;
+    rx_head = next;
+  }
+}
+
+// 接收缓冲中有未处理的字节（低功耗等待时用于提前唤醒）
+bool Param_Link_Rx_Pending(void) { return rx_tail != rx_head; }
+
+static bool Rx_Pop(uint8_t *byte) {
+  if (rx_tail == rx_head)
+    return false;
+  *byte = rx_buffer[rx_tail];
+  rx_tail = (rx_tail + 1) & (PARAM_LINK_RX_SIZE - 1);
+  return true;
+}
+
+static void Put_Float(uint8_t *dst, float value) {
+  memcpy(dst, &value, sizeof(value));
+}
+
+static float Get_Float(const uint8_t *src) {
+  float value;
+  memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+// 组帧并启动中断发送
+static void Send_Reply(uint8_t cmd, const uint8_t *payload, uint8_t len) {
+  tx_buffer[0] = PARAM_LINK_SYNC;
+  tx_buffer[1] = cmd | PARAM_LINK_REPLY;
+  tx_buffer[2] = len;
+  memcpy(&tx_buffer[3], payload, len);
+  tx_buffer[3 + len] = Crc8(0, &tx_buffer[1], len + 2);
+  tx_length = len + 4;
+}
+
+static void Flush_Reply(void) {
+  if (tx_length > 0 &&
+      HAL_UART_Transmit_IT(&huart1, tx_buffer, tx_length) == HAL_OK) {
+    tx_length = 0;
+  }
+}
+
+// 串口空闲且没有待发的调参应答时才允许发送遥测
+bool Param_Link_Tx_Idle(void) {
+  return tx_length == 0 && huart1.gState == HAL_UART_STATE_READY;
+}
+
+// 中断方式发送一段数据（data在发完之前必须保持有效）；失败时返回false
+bool Param_Link_Stream(const uint8_t *data, uint16_t len) {
+  return HAL_UART_Transmit_IT(&huart1, (uint8_t *)data, len) == HAL_OK;
+}
+
+// 写入Flash参数页并回读校验（擦除期间CPU停顿约20ms，只允许在空闲模式下进行）
+static Param_Status Flash_Commit(void) {
+  uint16_t words = Param_Image_Build(flash_image, PARAM_IMAGE_MAX_WORDS);
+  if (words == 0)
+    return PARAM_ERR_FLASH;
+
+  FLASH_EraseInitTypeDef erase = {0};
+  uint32_t page_error = 0;
+  erase.TypeErase = FLASH_TYPEERASE_PAGES;
+  erase.PageAddress = PARAM_FLASH_ADDR;
+  erase.NbPages = 1;
+
+  HAL_FLASH_Unlock();
+  HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &page_error);
+  for (uint16_t i = 0; i < words && status == HAL_OK; i++) {
+    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD,
+                               PARAM_FLASH_ADDR + i * 4, flash_image[i]);
+  }
+  HAL_FLASH_Lock();
+
+  if (status != HAL_OK ||
+      memcmp((const void *)PARAM_FLASH_ADDR, flash_image, words * 4) != 0)
+    return PARAM_ERR_FLASH;
+  return PARAM_OK;
+}
+
+// 执行一条命令并准备应答
+static void Handle_Frame(void) {
+  uint8_t reply[PARAM_LINK_MAX_PAYLOAD];
+  uint8_t len = 0;
+  uint8_t id = frame_payload[0];
+  Param_Status status = PARAM_OK;
+
+  switch (frame_cmd) {
+  case PARAM_CMD_COUNT:
+    reply[len++] = Param_Count();
+    break;
+
+  case PARAM_CMD_DESCRIBE: {
+    const Param_Desc *p = (frame_len == 1) ? Param_Get_Desc(id) : NULL;
+    if (p == NULL) {
+      reply[len++] = (frame_len == 1) ? PARAM_ERR_ID : PARAM_ERR_CMD;
+      break;
+    }
+    reply[len++] = id;
+    reply[len++] = p->type;
+    Put_Float(&reply[len], p->min);
+    Put_Float(&reply[len + 4], p->max);
+    len += 8;
+    uint8_t name_len = strlen(p->name);
+    if (name_len > PARAM_LINK_MAX_PAYLOAD - len)
+      name_len = PARAM_LINK_MAX_PAYLOAD - len;
+    memcpy(&reply[len], p->name, name_len);
+    len += name_len;
+    break;
+  }
+
+  case PARAM_CMD_GET:
+  case PARAM_CMD_SET:
+    if (frame_len != ((frame_cmd == PARAM_CMD_SET) ? 5 : 1)) {
+      status = PARAM_ERR_CMD;
+    } else if (id >= Param_Count()) {
+      status = PARAM_ERR_ID;
+    } else if (frame_cmd == PARAM_CMD_SET) {
+      status = Param_Set(id, Get_Float(&frame_payload[1]));
+    }
+    reply[len++] = id;
+    reply[len++] = status;
+    Put_Float(&reply[len], Param_Get(id));
+    len += 4;
+    break;
+
+  case PARAM_CMD_SNAPSHOT:
+    Param_Snapshot();
+    reply[len++] = PARAM_OK;
+    break;
+
+  case PARAM_CMD_REVERT:
+    Param_Revert();
+    reply[len++] = PARAM_OK;
+    break;
+
+  case PARAM_CMD_DEFAULTS:
+    Param_Load_Defaults();
+    reply[len++] = PARAM_OK;
+    break;
+
+  case PARAM_CMD_COMMIT:
+    // 擦写Flash会让CPU停顿，运行模式下拒绝
+    reply[len++] = (Mode_Manager_Current() != 0) ? PARAM_ERR_BUSY
+                                                 : Flash_Commit();
+    break;
+
+  case PARAM_CMD_BOX_INFO: {
+    const Black_Box *box = Black_Box_Get();
+    reply[len++] = PARAM_OK;
+    reply[len++] = box->trigger;
+    memcpy(&reply[len], &box->count, 2);
+    memcpy(&reply[len + 2], &box->trigger_index, 2);
+    memcpy(&reply[len + 4], &box->trigger_tick, 4);
+    len += 8;
+    break;
+  }
+
+  case PARAM_CMD_BOX_READ: {
+    uint16_t index = frame_payload[0] | (frame_payload[1] << 8);
+    const Black_Box_Record *record = Black_Box_Read(index);
+    memcpy(&reply[len], &index, 2);
+    len += 2;
+    if (frame_len != 2 || record == NULL) {
+      reply[len++] = (frame_len != 2) ? PARAM_ERR_CMD : PARAM_ERR_ID;
+      break;
+    }
+    reply[len++] = PARAM_OK;
+    memcpy(&reply[len], record, sizeof(*record));
+    len += sizeof(*record);
+    break;
+  }
+
+  case PARAM_CMD_BOX_ARM:
+    Black_Box_Arm();
+    reply[len++] = PARAM_OK;
+    break;
+
+  default:
+    reply[len++] = PARAM_ERR_CMD;
+    break;
+  }
+
+  Send_Reply(frame_cmd, reply, len);
+}
+
+// 初始化：记录默认值，加载Flash中保存的参数，启动接收
+void Param_Link_Init(void) {
+  Param_Table_Init();
+  if (Param_Image_Apply((const uint32_t *)PARAM_FLASH_ADDR,
+                        PARAM_IMAGE_MAX_WORDS)) {
+    printf("Params loaded from flash\r\n");
+  }
+  Param_Snapshot();
+  HAL_UART_Receive_IT(&huart1, &rx_byte, 1);
+}
+
+// 主循环调用：解析收到的字节，处理完整的帧
+// 返回帧外收到的最后一个普通字节（没有时返回-1）
+int16_t Param_Link_Poll(void) {
+  int16_t plain = -1;
+  uint8_t byte;
+
+  // 串口出错（溢出）时HAL会停止中断接收，重新启动
+  if (huart1.RxState == HAL_UART_STATE_READY)
+    HAL_UART_Receive_IT(&huart1, &rx_byte, 1);
+
+  Flush_Reply();
+  if (state != LINK_WAIT_SYNC &&
+      HAL_GetTick() - frame_start_ms > PARAM_LINK_FRAME_TIMEOUT_MS) {
+    state = LINK_WAIT_SYNC;
+  }
+
+  for (uint8_t n = 0; n < PARAM_LINK_BYTES_PER_POLL && tx_length == 0; n++) {
+    if (!Rx_Pop(&byte))
+      break;
+
+    switch (state) {
+    case LINK_WAIT_SYNC:
+      if (byte == PARAM_LINK_SYNC) {
+        state = LINK_WAIT_CMD;
+        frame_start_ms = HAL_GetTick();
+      } else {
+        plain = byte;
+      }
+      break;
+    case LINK_WAIT_CMD:
+      frame_cmd = byte;
+      state = LINK_WAIT_LEN;
+      break;
+    case LINK_WAIT_LEN:
+      frame_len = byte;
+      frame_pos = 0;
+      memset(frame_payload, 0, sizeof(frame_payload));
+      if (frame_len > PARAM_LINK_MAX_PAYLOAD)
+        state = LINK_WAIT_SYNC;
+      else
+        state = (frame_len > 0) ? LINK_PAYLOAD : LINK_WAIT_CRC;
+      break;
+    case LINK_PAYLOAD:
+      frame_payload[frame_pos++] = byte;
+      if (frame_pos == frame_len)
+        state = LINK_WAIT_CRC;
+      break;
+    case LINK_WAIT_CRC: {
+      uint8_t header[2] = {frame_cmd, frame_len};
+      uint8_t crc = Crc8(Crc8(0, header, 2), frame_payload, frame_len);
+      state = LINK_WAIT_SYNC;
+      if (byte == crc)
+        Handle_Frame();
+      break;
+    }
+    }
+  }
+
+  Flush_Reply();
+  return plain;
+}
@@ -0,0 +1,49 @@
+#ifndef __PARAM_LINK_H
+#define __PARAM_LINK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 串口调参协议（USART1，与printf共用）
+// 请求：SYNC cmd len payload[len] crc8
+// 应答：SYNC cmd|0x80 len payload[len] crc8
+// crc8（多项式0x07，初值0）覆盖 cmd、len 和 payload；校验错误的帧直接丢弃，由上位机重发
+// 多字节字段均为小端，数值统一按float传输；SYNC不是ASCII字符，不会与printf文本混淆
+// 帧外收到的'0'-'9'交给模式管理器作为模式切换命令
+// 上位机工具见 host/param_tool.c
+// CCD遥测包（ccd_telemetry.h）也经本模块发送，调参应答优先
+
+#define PARAM_LINK_SYNC 0xA5
+#define PARAM_LINK_REPLY 0x80
+#define PARAM_LINK_MAX_PAYLOAD 32
+
+// 命令                           请求payload   应答payload
+#define PARAM_CMD_COUNT 0x01    // -             count
+#define PARAM_CMD_DESCRIBE 0x02 // id            id type min max name（出错时只有status）
+#define PARAM_CMD_GET 0x03      // id            id status value
+#define PARAM_CMD_SET 0x04      // id value      id status value
+#define PARAM_CMD_SNAPSHOT 0x05 // -             status
+#define PARAM_CMD_REVERT 0x06   // -             status
+#define PARAM_CMD_DEFAULTS 0x07 // -             status
+#define PARAM_CMD_COMMIT 0x08   // -             status（仅空闲模式下允许）
+#define PARAM_CMD_BOX_INFO 0x09 // -             status trigger count(2) index(2) tick(4)
+#define PARAM_CMD_BOX_READ 0x0A // index(2)      index(2) status record（black_box.h）
+#define PARAM_CMD_BOX_ARM 0x0B  // -             status（清空黑匣子并重新记录）
+
+// 接收和解析
+#define PARAM_LINK_RX_SIZE 64          // 接收环形缓冲（2的幂）
+#define PARAM_LINK_BYTES_PER_POLL 32   // 每次轮询最多处理的字节数
+#define PARAM_LINK_FRAME_TIMEOUT_MS 50 // 半帧超时后丢弃
+
+// Flash参数页（STM32F103xE最后一页，每页2KB）
+#define PARAM_FLASH_ADDR 0x0807F800u
+
+// 函数声明
+void Param_Link_Init(void);
+int16_t Param_Link_Poll(void);
+void Param_Link_Rx_Byte(uint8_t byte);
+bool Param_Link_Rx_Pending(void);
+bool Param_Link_Tx_Idle(void);
+bool Param_Link_Stream(const uint8_t *data, uint16_t len);
+
+#endif
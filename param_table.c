@@ -0,0 +1,205 @@
+#include "param_table.h"
+#include "bsp_ccd.h"
+#include "line_tracking.h"
+#include "mode_manager.h"
+#include <string.h>
+
+// 参数登记表（编号即下标，只能在表尾追加）
+static const Param_Desc param_table[] = {
+    // 巡线
+    {"trk.base", &track_config.base_speed, PARAM_I16, 0, 2000},
+    {"trk.max", &track_config.max_speed, PARAM_I16, 0, 2000},
+    {"trk.min", &track_config.min_speed, PARAM_I16, 0, 2000},
+    {"trk.diff", &track_config.max_speed_diff, PARAM_I16, 0, 2000},
+    {"trk.lost", &track_config.lost_threshold, PARAM_U8, 1, 255},
+
+    // CCD曝光控制
+    {"ccd.tmax", &ccd_config.target_max, PARAM_U16, 1, 255},
+    {"ccd.tmin", &ccd_config.target_min, PARAM_U16, 0, 254},
+    {"ccd.emin", &ccd_config.min_exposure, PARAM_U8, 1, 255},
+    {"ccd.emax", &ccd_config.max_exposure, PARAM_U8, 1, 255},
+
+    // 超声跟随避障
+    {"fa.stop", &follow_avoid_config.stop_distance, PARAM_F32, 0, 100},
+    {"fa.max", &follow_avoid_config.max_distance, PARAM_F32, 0, 400},
+    {"fa.gap", &follow_avoid_config.base_distance, PARAM_F32, 0, 400},
+    {"fa.base", &follow_avoid_config.base_speed, PARAM_I16, 0, 2000},
+    {"fa.vmax", &follow_avoid_config.max_speed, PARAM_I16, 0, 2000},
+    {"fa.turn", &follow_avoid_config.turn_speed, PARAM_I16, 0, 2000},
+    {"fa.vmin", &follow_avoid_config.min_speed, PARAM_I16, 0, 2000},
+    {"fa.ir", &follow_avoid_config.ir_threshold, PARAM_U16, 0, 4095},
+    {"fa.again", &follow_avoid_config.avoid_turn_gain, PARAM_I16, 0, 2000},
+    {"fa.amax", &follow_avoid_config.avoid_max_turn, PARAM_I16, 0, 2000},
+
+    // 巡线转向PID和弯道降速
+    {"trk.kp", &track_config.kp, PARAM_F32, 0, 100},
+    {"trk.ki", &track_config.ki, PARAM_F32, 0, 10},
+    {"trk.kd", &track_config.kd, PARAM_F32, 0, 100},
+    {"trk.slow", &track_config.speed_reduce_ratio, PARAM_F32, 0, 1},
+
+    // CCD遥测
+    {"tel.on", &ccd_config.stream, PARAM_U8, 0, 1},
+    {"tel.key", &ccd_config.keyframe_interval, PARAM_U8, 1, 255},
+    {"ccd.thr", &ccd_config.threshold_mode, PARAM_U8, 0, 1},
+    {"ccd.local", &ccd_config.local_blend, PARAM_U8, 0, 100},
+    {"ccd.tf", &ccd_config.temporal_weight, PARAM_U8, 0, 16},
+    {"ccd.os", &ccd_config.oversample, PARAM_U8, 1, CCD_OVERSAMPLE_MAX},
+
+    // 巡线纯追踪转向
+    {"trk.steer", &track_config.steer_mode, PARAM_U8, 0, 1},
+    {"trk.ldmin", &track_config.lookahead_min, PARAM_F32, 0, 100},
+    {"trk.ldmax", &track_config.lookahead_max, PARAM_F32, 0, 100},
+    {"trk.ppk", &track_config.pursuit_gain, PARAM_F32, 0, 5},
+
+    // 跟随丢失距离
+    {"fa.lost", &follow_avoid_config.lost_distance, PARAM_F32, 0, 400},
+};
+
+#define PARAM_COUNT (sizeof(param_table) / sizeof(param_table[0]))
+
+static float default_values[PARAM_COUNT]; // 编译时默认值
+static float snapshot_values[PARAM_COUNT];
+
+// CRC-16/CCITT
+static uint16_t Crc16(uint16_t crc, const uint8_t *data, uint32_t len) {
+  while (len--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// 表结构校验（前count项）：名称和类型变化后，旧镜像不再被接受
+static uint16_t Layout_Crc(uint8_t count) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < count; i++) {
+    const Param_Desc *p = &param_table[i];
+    uint8_t type = p->type;
+    crc = Crc16(crc, (const uint8_t *)p->name, strlen(p->name));
+    crc = Crc16(crc, &type, 1);
+  }
+  return crc;
+}
+
+// 初始化：记录编译时默认值（需在加载Flash中的参数之前调用）
+void Param_Table_Init(void) {
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    default_values[i] = Param_Get(i);
+    snapshot_values[i] = default_values[i];
+  }
+}
+
+uint8_t Param_Count(void) { return PARAM_COUNT; }
+
+const Param_Desc *Param_Get_Desc(uint8_t id) {
+  return (id < PARAM_COUNT) ? &param_table[id] : NULL;
+}
+
+// 读取参数（统一转换为float）
+float Param_Get(uint8_t id) {
+  if (id >= PARAM_COUNT)
+    return 0.0f;
+
+  const Param_Desc *p = &param_table[id];
+  switch (p->type) {
+  case PARAM_I16:
+    return *(int16_t *)p->value;
+  case PARAM_U16:
+    return *(uint16_t *)p->value;
+  case PARAM_U8:
+    return *(uint8_t *)p->value;
+  case PARAM_F32:
+    return *(float *)p->value;
+  default:
+    return 0.0f;
+  }
+}
+
+// 写入参数：超出上下限时拒绝，整数类型四舍五入
+Param_Status Param_Set(uint8_t id, float value) {
+  if (id >= PARAM_COUNT)
+    return PARAM_ERR_ID;
+
+  const Param_Desc *p = &param_table[id];
+  // 取反比较使NaN同样被拒绝
+  if (!(value >= p->min && value <= p->max))
+    return PARAM_ERR_RANGE;
+
+  float rounded = (value >= 0.0f) ? value + 0.5f : value - 0.5f;
+  switch (p->type) {
+  case PARAM_I16:
+    *(int16_t *)p->value = (int16_t)rounded;
+    break;
+  case PARAM_U16:
+    *(uint16_t *)p->value = (uint16_t)rounded;
+    break;
+  case PARAM_U8:
+    *(uint8_t *)p->value = (uint8_t)rounded;
+    break;
+  case PARAM_F32:
+    *(float *)p->value = value;
+    break;
+  }
+  return PARAM_OK;
+}
+
+// 快照：调参前保存当前值，调坏了可以一次恢复
+void Param_Snapshot(void) {
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    snapshot_values[i] = Param_Get(i);
+  }
+}
+
+void Param_Revert(void) {
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    Param_Set(i, snapshot_values[i]);
+  }
+}
+
+void Param_Load_Defaults(void) {
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    Param_Set(i, default_values[i]);
+  }
+}
+
+// 生成Flash镜像，返回字数（空间不足时返回0）
+uint16_t Param_Image_Build(uint32_t *words, uint16_t max_words) {
+  uint16_t count = PARAM_COUNT + 3;
+  if (count > max_words)
+    return 0;
+
+  words[0] = PARAM_IMAGE_MAGIC;
+  words[1] = PARAM_COUNT | ((uint32_t)Layout_Crc(PARAM_COUNT) << 16);
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    float value = Param_Get(i);
+    memcpy(&words[2 + i], &value, sizeof(value));
+  }
+  words[count - 1] =
+      Crc16(0xFFFF, (const uint8_t *)words, (count - 1) * sizeof(uint32_t));
+  return count;
+}
+
+// 校验并应用Flash镜像；镜像无效或与当前参数表不匹配时不做任何修改
+// 表尾追加参数之前保存的镜像（参数较少且布局与当前表的前段一致）同样接受，
+// 新追加的参数保持编译时默认值
+bool Param_Image_Apply(const uint32_t *words, uint16_t max_words) {
+  if (max_words < 3 || words[0] != PARAM_IMAGE_MAGIC)
+    return false;
+  uint16_t saved = words[1] & 0xFFFF;
+  uint16_t count = saved + 3;
+  if (saved == 0 || saved > PARAM_COUNT || count > max_words ||
+      (words[1] >> 16) != Layout_Crc(saved))
+    return false;
+  if (words[count - 1] !=
+      Crc16(0xFFFF, (const uint8_t *)words, (count - 1) * sizeof(uint32_t)))
+    return false;
+
+  for (uint8_t i = 0; i < saved; i++) {
+    float value;
+    memcpy(&value, &words[2 + i], sizeof(value));
+    Param_Set(i, value);
+  }
+  return true;
+}
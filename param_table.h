@@ -0,0 +1,55 @@
+#ifndef __PARAM_TABLE_H
+#define __PARAM_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 运行时参数表：把各模块的可调参数登记成带类型和上下限的条目，
+// 按编号读写，支持快照/恢复和生成Flash镜像
+// 本模块不直接访问硬件，串口协议和Flash读写见 param_link.c
+// 编号即表中下标：新增参数只能追加到表尾，否则已保存的镜像和上位机配置会失效
+// （追加前保存的镜像仍可加载，追加的参数取默认值）
+
+// 参数类型
+typedef enum {
+  PARAM_I16 = 0,
+  PARAM_U16,
+  PARAM_U8,
+  PARAM_F32,
+} Param_Type;
+
+// 操作结果（同时作为串口应答中的状态码）
+typedef enum {
+  PARAM_OK = 0,
+  PARAM_ERR_ID,    // 编号不存在
+  PARAM_ERR_RANGE, // 超出上下限，未修改
+  PARAM_ERR_BUSY,  // 当前状态不允许（如运行中写Flash）
+  PARAM_ERR_FLASH, // Flash擦写或校验失败
+  PARAM_ERR_CMD,   // 未知命令或长度错误
+} Param_Status;
+
+typedef struct {
+  const char *name; // 短名称，格式为"模块.参数"
+  void *value;      // 指向模块中的实际变量
+  Param_Type type;
+  float min;
+  float max;
+} Param_Desc;
+
+// Flash镜像：魔数、数量和布局校验、各参数值（float位模式）、整体CRC
+#define PARAM_IMAGE_MAGIC 0x314D5250u // "PRM1"
+#define PARAM_IMAGE_MAX_WORDS 64
+
+// 函数声明
+void Param_Table_Init(void);
+uint8_t Param_Count(void);
+const Param_Desc *Param_Get_Desc(uint8_t id);
+float Param_Get(uint8_t id);
+Param_Status Param_Set(uint8_t id, float value);
+void Param_Snapshot(void);
+void Param_Revert(void);
+void Param_Load_Defaults(void);
+uint16_t Param_Image_Build(uint32_t *words, uint16_t max_words);
+bool Param_Image_Apply(const uint32_t *words, uint16_t max_words);
+
+#endif
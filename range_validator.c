@@ -0,0 +1,98 @@
+#include "range_validator.h"
+
+// 计算窗口中值（窗口很小，插入排序即可）
+static float Window_Median(const Range_Validator *rv) {
+  float sorted[RANGE_MEDIAN_SIZE];
+
+  for (int i = 0; i < rv->count; i++) {
+    float value = rv->window[i];
+    int j = i - 1;
+    while (j >= 0 && sorted[j] > value) {
+      sorted[j + 1] = sorted[j];
+      j--;
+    }
+    sorted[j + 1] = value;
+  }
+  return sorted[rv->count / 2];
+}
+
+static void Window_Push(Range_Validator *rv, float value) {
+  rv->window[rv->head] = value;
+  rv->head = (rv->head + 1) % RANGE_MEDIAN_SIZE;
+  if (rv->count < RANGE_MEDIAN_SIZE)
+    rv->count++;
+}
+
+// 初始化检验器
+void Range_Validator_Init(Range_Validator *rv) {
+  rv->head = 0;
+  rv->count = 0;
+  rv->reject_run = 0;
+  rv->last_valid = 0.0f;
+  rv->last_ms = 0;
+  rv->status = RANGE_STATUS_TIMEOUT;
+  rv->counters = (Range_Counters){0};
+}
+
+// 检验一次原始读数，仅在返回RANGE_STATUS_OK时写出validated
+Range_Status Range_Validator_Update(Range_Validator *rv, float raw,
+                                    uint32_t now_ms, float *validated) {
+  rv->counters.total++;
+
+  // 1. 量程检查
+  if (raw < RANGE_MIN_VALID_CM) {
+    rv->counters.timeout++;
+    rv->status = RANGE_STATUS_TIMEOUT;
+    return rv->status;
+  }
+  if (raw > RANGE_MAX_VALID_CM) {
+    rv->counters.no_echo++;
+    rv->status = RANGE_STATUS_NO_ECHO;
+    return rv->status;
+  }
+
+  // 2. 滑动中值，抑制单次虚假回波
+  Window_Push(rv, raw);
+  float median = Window_Median(rv);
+
+  // 3. 变化率门限：相对上次有效值的变化不能超过物理极限
+  if (rv->counters.ok > 0) {
+    float dt = (now_ms - rv->last_ms) * 0.001f;
+    float limit = RANGE_MAX_RATE_CM_S * dt + RANGE_GATE_MARGIN_CM;
+    float change = median - rv->last_valid;
+
+    if (change > limit || change < -limit) {
+      if (++rv->reject_run <= RANGE_MAX_REJECTS) {
+        rv->counters.outlier++;
+        rv->status = RANGE_STATUS_OUTLIER;
+        return rv->status;
+      }
+      // 连续剔除说明目标确实跳变（如换了目标），以当前中值重新建立基准
+      rv->counters.reseed++;
+    }
+  }
+
+  rv->reject_run = 0;
+  rv->last_valid = median;
+  rv->last_ms = now_ms;
+  rv->counters.ok++;
+  rv->status = RANGE_STATUS_OK;
+  *validated = median;
+  return rv->status;
+}
+
+// 状态名称（用于调试输出）
+const char *Range_Status_Name(Range_Status status) {
+  switch (status) {
+  case RANGE_STATUS_OK:
+    return "OK";
+  case RANGE_STATUS_TIMEOUT:
+    return "TIMEOUT";
+  case RANGE_STATUS_NO_ECHO:
+    return "NO_ECHO";
+  case RANGE_STATUS_OUTLIER:
+    return "OUTLIER";
+  default:
+    return "?";
+  }
+}
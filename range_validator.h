@@ -0,0 +1,53 @@
+#ifndef __RANGE_VALIDATOR_H
+#define __RANGE_VALIDATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 超声测距有效性检验：量程检查 + 滑动中值 + 变化率门限
+// 纯算法模块，不依赖HAL，可直接在主机上编译
+
+// 参数定义
+#define RANGE_MEDIAN_SIZE 5        // 滑动中值窗口长度（奇数）
+#define RANGE_MIN_VALID_CM 0.5f    // 低于该值视为超时（驱动超时返回0）
+#define RANGE_MAX_VALID_CM 400.0f  // 超过该值视为无回波
+#define RANGE_MAX_RATE_CM_S 300.0f // 物理上可能的最大距离变化率
+#define RANGE_GATE_MARGIN_CM 2.0f  // 变化率门限的固定余量
+#define RANGE_MAX_REJECTS 5        // 连续剔除次数上限，超过后重新建立基准
+
+// 测量状态
+typedef enum {
+  RANGE_STATUS_OK = 0,  // 有效测量
+  RANGE_STATUS_TIMEOUT, // 传感器超时（无有效读数）
+  RANGE_STATUS_NO_ECHO, // 超出量程，前方无回波
+  RANGE_STATUS_OUTLIER, // 被变化率门限剔除
+} Range_Status;
+
+// 诊断计数器
+typedef struct {
+  uint32_t total;
+  uint32_t ok;
+  uint32_t timeout;
+  uint32_t no_echo;
+  uint32_t outlier;
+  uint32_t reseed; // 连续剔除后重新建立基准的次数
+} Range_Counters;
+
+typedef struct {
+  float window[RANGE_MEDIAN_SIZE]; // 有效读数环形缓冲
+  uint8_t head;
+  uint8_t count;
+  uint8_t reject_run; // 连续被门限剔除的次数
+  float last_valid;   // 最近一次通过检验的距离
+  uint32_t last_ms;   // 最近一次通过检验的时间
+  Range_Status status;
+  Range_Counters counters;
+} Range_Validator;
+
+// 函数声明
+void Range_Validator_Init(Range_Validator *rv);
+Range_Status Range_Validator_Update(Range_Validator *rv, float raw,
+                                    uint32_t now_ms, float *validated);
+const char *Range_Status_Name(Range_Status status);
+
+#endif
@@ -0,0 +1,94 @@
+#include "sensor_channel.h"
+#include <string.h>
+
+// 内存顺序：生产者先写数据再以release发布计数，消费者以acquire读取计数后
+// 再读数据；Cortex-M3单核上release/acquire编译为DMB，主机上为真正的多核同步
+
+void Sensor_Ring_Init(Sensor_Ring *ring) {
+  atomic_init(&ring->head, 0);
+  atomic_init(&ring->tail, 0);
+  atomic_init(&ring->dropped, 0);
+}
+
+// 生产者（中断）调用：环满时丢弃本事件，返回false
+bool Sensor_Ring_Push(Sensor_Ring *ring, const Sensor_Event *event) {
+  unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  if (head - tail >= SENSOR_RING_SIZE) {
+    atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+    return false;
+  }
+
+  ring->slot[head & (SENSOR_RING_SIZE - 1)] = *event;
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+  return true;
+}
+
+// 消费者（主循环）调用：取出最早的事件，环空时返回false
+bool Sensor_Ring_Pop(Sensor_Ring *ring, Sensor_Event *event) {
+  unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  if (head == tail)
+    return false;
+
+  *event = ring->slot[tail & (SENSOR_RING_SIZE - 1)];
+  atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+  return true;
+}
+
+uint32_t Sensor_Ring_Dropped(const Sensor_Ring *ring) {
+  return atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
+
+void Sensor_Snapshot_Init(Sensor_Snapshot *snap) {
+  atomic_init(&snap->seq, 0);
+  for (uint8_t i = 0; i < SENSOR_SNAPSHOT_WORDS; i++) {
+    atomic_init(&snap->word[i], 0);
+  }
+}
+
+// 唯一的生产者调用，size不超过 SENSOR_SNAPSHOT_WORDS*4 字节
+// 数据按字写入原子变量，读者与写者并发时不会出现数据竞争
+void Sensor_Snapshot_Write(Sensor_Snapshot *snap, const void *data,
+                           uint8_t size) {
+  uint32_t words[SENSOR_SNAPSHOT_WORDS] = {0};
+  uint8_t count = (size + 3) / 4;
+  if (count > SENSOR_SNAPSHOT_WORDS)
+    count = SENSOR_SNAPSHOT_WORDS;
+  memcpy(words, data, (size < sizeof(words)) ? size : sizeof(words));
+
+  unsigned seq = atomic_load_explicit(&snap->seq, memory_order_relaxed);
+  atomic_store_explicit(&snap->seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  for (uint8_t i = 0; i < count; i++) {
+    atomic_store_explicit(&snap->word[i], words[i], memory_order_relaxed);
+  }
+  atomic_store_explicit(&snap->seq, seq + 2, memory_order_release);
+}
+
+// 读取最新快照；尚无数据或重读 SENSOR_READ_RETRIES 次仍被打断时返回false
+// （板上写者是中断，打断一次后必定写完，重读一次即可成功）
+bool Sensor_Snapshot_Read(Sensor_Snapshot *snap, void *data, uint8_t size) {
+  uint32_t words[SENSOR_SNAPSHOT_WORDS];
+  uint8_t count = (size + 3) / 4;
+  if (count > SENSOR_SNAPSHOT_WORDS)
+    count = SENSOR_SNAPSHOT_WORDS;
+
+  for (uint8_t attempt = 0; attempt <= SENSOR_READ_RETRIES; attempt++) {
+    unsigned begin = atomic_load_explicit(&snap->seq, memory_order_acquire);
+    if (begin == 0)
+      return false;
+    if (begin & 1)
+      continue;
+
+    for (uint8_t i = 0; i < count; i++) {
+      words[i] = atomic_load_explicit(&snap->word[i], memory_order_relaxed);
+    }
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&snap->seq, memory_order_relaxed) == begin) {
+      memcpy(data, words, (size < sizeof(words)) ? size : sizeof(words));
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,53 @@
+#ifndef __SENSOR_CHANNEL_H
+#define __SENSOR_CHANNEL_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// 中断到主循环的传感器数据通道：不加锁、不关中断、不分配内存
+// - 事件环：单生产者（一个中断）单消费者（主循环），按顺序传递带时刻的事件，
+//   环满时丢弃新事件并计数，生产者从不等待
+// - 快照：顺序锁，生产者随时覆盖最新值；读者发现读取期间被改写时重读，
+//   不会读到一半新一半旧的数据
+// 纯算法模块，主机上用线程做压力测试（host/channel_stress.c）
+
+#define SENSOR_RING_SIZE 16      // 事件环容量（2的幂）
+#define SENSOR_SNAPSHOT_WORDS 12 // 快照最大长度（32位字）
+#define SENSOR_READ_RETRIES 4    // 快照读取被打断时的重读次数
+
+// 事件来源
+#define SENSOR_EVENT_KEY 1        // value为按键编号，flags为1按下、0松开
+#define SENSOR_EVENT_RANGE 2      // value为超声回波距离 (mm)
+#define SENSOR_EVENT_VISION_CMD 3 // flags为视觉指令编号，value为指令参数
+
+typedef struct {
+  uint32_t tick; // 中断中的采样时刻 (ms)
+  uint8_t source;
+  uint8_t flags;
+  int32_t value;
+} Sensor_Event;
+
+typedef struct {
+  Sensor_Event slot[SENSOR_RING_SIZE];
+  atomic_uint head;    // 写入计数（只由生产者修改）
+  atomic_uint tail;    // 读取计数（只由消费者修改）
+  atomic_uint dropped; // 环满时丢弃的事件数
+} Sensor_Ring;
+
+typedef struct {
+  atomic_uint seq; // 写入次数的2倍，奇数表示正在写入，0表示尚无数据
+  atomic_uint word[SENSOR_SNAPSHOT_WORDS];
+} Sensor_Snapshot;
+
+// 函数声明
+void Sensor_Ring_Init(Sensor_Ring *ring);
+bool Sensor_Ring_Push(Sensor_Ring *ring, const Sensor_Event *event);
+bool Sensor_Ring_Pop(Sensor_Ring *ring, Sensor_Event *event);
+uint32_t Sensor_Ring_Dropped(const Sensor_Ring *ring);
+void Sensor_Snapshot_Init(Sensor_Snapshot *snap);
+void Sensor_Snapshot_Write(Sensor_Snapshot *snap, const void *data,
+                           uint8_t size);
+bool Sensor_Snapshot_Read(Sensor_Snapshot *snap, void *data, uint8_t size);
+
+#endif
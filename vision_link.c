@@ -0,0 +1,148 @@
+#include "vision_link.h"
+#include <string.h>
+
+Sensor_Snapshot vision_line_channel;
+Sensor_Snapshot vision_object_channel;
+Sensor_Ring vision_command_ring;
+
+// DMA循环写入；parse_pos 之前的字节已处理，之后到DMA写入位置为待解析
+static uint8_t rx_buffer[VISION_LINK_RX_SIZE];
+static uint16_t parse_pos = 0;
+static bool seq_valid = false;
+static uint8_t next_seq;
+static Vision_Link_Stats stats;
+
+#define RX_MASK (VISION_LINK_RX_SIZE - 1)
+
+// 按环形下标读字段
+static uint8_t Rx_U8(uint16_t pos) { return rx_buffer[pos & RX_MASK]; }
+
+static int16_t Rx_I16(uint16_t pos) {
+  return (int16_t)(Rx_U8(pos) | (Rx_U8(pos + 1) << 8));
+}
+
+static uint8_t Rx_Crc8(uint16_t pos, uint8_t len) {
+  uint8_t crc = 0;
+  while (len--) {
+    crc ^= Rx_U8(pos++);
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+void Vision_Link_Init(void) {
+  parse_pos = 0;
+  seq_valid = false;
+  memset(&stats, 0, sizeof(stats));
+  Sensor_Snapshot_Init(&vision_line_channel);
+  Sensor_Snapshot_Init(&vision_object_channel);
+  Sensor_Ring_Init(&vision_command_ring);
+}
+
+// DMA目标缓冲（VISION_LINK_RX_SIZE 字节）
+uint8_t *Vision_Link_Rx_Buffer(void) { return rx_buffer; }
+
+// 重新启动DMA接收前调用：DMA从缓冲开头写起，丢弃未解析完的字节
+void Vision_Link_Rx_Restart(void) {
+  parse_pos = 0;
+  seq_valid = false;
+  stats.restarts++;
+}
+
+// 各类消息的payload长度，未知类型返回0
+static uint8_t Payload_Length(uint8_t type) {
+  switch (type) {
+  case VISION_MSG_LINE:
+    return 5;
+  case VISION_MSG_OBJECT:
+    return 9;
+  case VISION_MSG_COMMAND:
+    return 3;
+  default:
+    return 0;
+  }
+}
+
+// 分发一帧（pos指向payload，长度已检查）
+static void Handle_Frame(uint8_t type, uint8_t seq, uint16_t pos,
+                         uint32_t tick) {
+  switch (type) {
+  case VISION_MSG_LINE: {
+    Vision_Line line = {tick, Rx_I16(pos), Rx_I16(pos + 2), Rx_U8(pos + 4),
+                        seq};
+    Sensor_Snapshot_Write(&vision_line_channel, &line, sizeof(line));
+    break;
+  }
+
+  case VISION_MSG_OBJECT: {
+    Vision_Object object = {tick,
+                            Rx_U8(pos),
+                            Rx_U8(pos + 1),
+                            Rx_I16(pos + 2),
+                            Rx_I16(pos + 4),
+                            (uint16_t)Rx_I16(pos + 6),
+                            Rx_U8(pos + 8),
+                            seq};
+    Sensor_Snapshot_Write(&vision_object_channel, &object, sizeof(object));
+    break;
+  }
+
+  case VISION_MSG_COMMAND: {
+    Sensor_Event event = {tick, SENSOR_EVENT_VISION_CMD, Rx_U8(pos),
+                          Rx_I16(pos + 1)};
+    Sensor_Ring_Push(&vision_command_ring, &event);
+    break;
+  }
+  }
+}
+
+// 接收事件中断调用：position为DMA当前写入位置（等于缓冲长度时即回到0）
+// 解析到不完整的帧为止，剩余字节留到下一次；
+// 两次调用之间DMA写入超过一圈会覆盖未解析的字节，表现为校验错误
+void Vision_Link_Rx_Update(uint16_t position, uint32_t tick) {
+  uint16_t write_pos = position & RX_MASK;
+
+  while (parse_pos != write_pos) {
+    uint16_t available = (write_pos - parse_pos) & RX_MASK;
+    if (Rx_U8(parse_pos) != VISION_LINK_SYNC) {
+      parse_pos = (parse_pos + 1) & RX_MASK;
+      stats.skipped++;
+      continue;
+    }
+    if (available < VISION_LINK_HEADER)
+      break;
+
+    uint8_t type = Rx_U8(parse_pos + 1);
+    uint8_t len = Rx_U8(parse_pos + 3);
+    if (len == 0 || len != Payload_Length(type)) {
+      // 类型未知或长度不符，不可能是帧头：当作普通字节跳过，
+      // 避免把数据中的SYNC当成帧头后吞掉后面真正的帧
+      parse_pos = (parse_pos + 1) & RX_MASK;
+      stats.bad_frames++;
+      continue;
+    }
+    if (available < VISION_LINK_HEADER + len + 1)
+      break;
+
+    uint8_t crc = Rx_Crc8(parse_pos + 1, VISION_LINK_HEADER - 1 + len);
+    if (crc != Rx_U8(parse_pos + VISION_LINK_HEADER + len)) {
+      parse_pos = (parse_pos + 1) & RX_MASK;
+      stats.crc_errors++;
+      continue;
+    }
+
+    uint8_t seq = Rx_U8(parse_pos + 2);
+    if (seq_valid)
+      stats.lost += (uint8_t)(seq - next_seq);
+    next_seq = seq + 1;
+    seq_valid = true;
+
+    Handle_Frame(type, seq, parse_pos + VISION_LINK_HEADER, tick);
+    stats.frames++;
+    parse_pos = (parse_pos + VISION_LINK_HEADER + len + 1) & RX_MASK;
+  }
+}
+
+const Vision_Link_Stats *Vision_Link_Get_Stats(void) { return &stats; }
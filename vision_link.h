@@ -0,0 +1,78 @@
+#ifndef __VISION_LINK_H
+#define __VISION_LINK_H
+
+#include "sensor_channel.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 视觉协处理器链路（USART2，DMA循环接收）
+// 帧：SYNC type seq len payload[len] crc8
+// crc8（多项式0x07，初值0）覆盖 type、seq、len 和 payload，与串口调参相同
+// seq 每发一帧加1，接收端按跳号统计丢帧；多字节字段均为小端
+// DMA把字节循环写入接收缓冲，空闲、半满、全满中断给出写入位置，
+// 中断中直接在接收缓冲上按环形下标解析（不复制整帧），结果写入快照或事件环
+// 纯算法模块，主机上用 host/vision_sim.c 按脚本生成结果流做回环测试
+
+#define VISION_LINK_SYNC 0x5A
+#define VISION_LINK_MAX_PAYLOAD 16
+#define VISION_LINK_RX_SIZE 128 // DMA接收缓冲（2的幂）
+#define VISION_LINK_HEADER 4    // SYNC type seq len
+#define VISION_STALE_MS 200     // 结果超过该时间未更新视为相机失效
+
+// 消息                          payload
+#define VISION_MSG_LINE 0x01    // offset(2) angle(2) confidence
+#define VISION_MSG_OBJECT 0x02  // class label x(2) y(2) size(2) confidence
+#define VISION_MSG_COMMAND 0x03 // code arg(2)
+
+// 坐标以画面中心为原点、半宽为1000归一化，x向右、y向上为正
+// 识别类别
+#define VISION_CLASS_COLOR 1 // label为颜色编号
+#define VISION_CLASS_DIGIT 2 // label为数字0~9
+
+// 二维码指令（经 vision_command_ring 传给模式管理器）
+#define VISION_CMD_MODE 1 // arg为模式编号，同串口数字命令
+#define VISION_CMD_STOP 2 // 回到选择菜单
+
+// 巡线结果
+typedef struct {
+  uint32_t tick;      // 收到的时刻 (ms)
+  int16_t offset;     // 线相对画面中心的横向位置，线在右侧为正
+  int16_t angle;      // 线的走向 (0.1度)，向右偏为正
+  uint8_t confidence; // 置信度 0~100，0为未检出
+  uint8_t seq;
+} Vision_Line;
+
+// 识别结果
+typedef struct {
+  uint32_t tick;
+  uint8_t object_class; // VISION_CLASS_*
+  uint8_t label;
+  int16_t x;
+  int16_t y;
+  uint16_t size; // 目标宽度（同一归一化单位）
+  uint8_t confidence;
+  uint8_t seq;
+} Vision_Object;
+
+// 诊断计数器
+typedef struct {
+  uint32_t frames;     // 校验通过的帧
+  uint32_t crc_errors; // 校验错误（丢弃后从下一个字节重新找SYNC）
+  uint32_t bad_frames; // 类型未知或长度不符的帧头
+  uint32_t lost;       // 按seq跳号推算的丢帧
+  uint32_t skipped;    // 帧外被跳过的字节
+  uint32_t restarts;   // 串口出错后重新启动接收的次数
+} Vision_Link_Stats;
+
+extern Sensor_Snapshot vision_line_channel;   // Vision_Line
+extern Sensor_Snapshot vision_object_channel; // Vision_Object
+extern Sensor_Ring vision_command_ring; // source为SENSOR_EVENT_VISION_CMD
+
+// 函数声明
+void Vision_Link_Init(void);
+uint8_t *Vision_Link_Rx_Buffer(void);
+void Vision_Link_Rx_Restart(void);
+void Vision_Link_Rx_Update(uint16_t position, uint32_t tick);
+const Vision_Link_Stats *Vision_Link_Get_Stats(void);
+
+#endif
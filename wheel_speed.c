@@ -0,0 +1,85 @@
+#include "wheel_speed.h"
+#include "odometry.h"
+#include <string.h>
+
+// 清零即为初始状态（静态变量可不调用）
+void Wheel_Speed_Init(Wheel_Speed *ws) { memset(ws, 0, sizeof(*ws)); }
+
+// 窗口结束：算出窗口平均速度，与上一个窗口比较得到加速度
+static void Close_Window(Wheel_Speed *ws, int32_t count, uint32_t edge_us) {
+  uint32_t window = edge_us - ws->last_edge;
+  float speed = (count - ws->last_count) * 1000000.0f / window;
+  uint32_t mid = ws->last_edge + window / 2;
+
+  if (ws->has_window) {
+    float dt = (mid - ws->window_mid) * 1e-6f;
+    ws->accel += WHEEL_SPEED_ACCEL_ALPHA *
+                 ((speed - ws->window_speed) / dt - ws->accel);
+  } else {
+    ws->accel = 0.0f;
+  }
+  ws->window_speed = speed;
+  ws->window_mid = mid;
+  ws->has_window = true;
+  ws->last_count = count;
+  ws->last_edge = edge_us;
+}
+
+// 更新并返回采样时刻的速度 (计数/秒)
+// 窗口跨过整数个正交周期（刻线误差抵消）、或计数足够多、或等待超过
+// 最长时间时结束，窗口速度 = 计数增量 / 首末边沿的时间差
+// 两次边沿之间下一个边沿至少还要再等 (now - 最近边沿)，速度不会超过其倒数
+float Wheel_Speed_Update(Wheel_Speed *ws, int32_t count, uint32_t edge_us,
+                         uint32_t now_us) {
+  if (!ws->initialized) {
+    ws->last_count = count;
+    ws->stopped = true;
+    ws->initialized = true;
+    return ws->speed;
+  }
+  // 停止后的第一个边沿只作为计时起点（静止的时间不算进窗口）
+  if (ws->stopped) {
+    if (count != ws->last_count) {
+      ws->last_count = count;
+      ws->last_edge = edge_us;
+      ws->stopped = false;
+    }
+    return ws->speed;
+  }
+
+  int32_t delta = count - ws->last_count;
+  uint32_t magnitude = (delta < 0) ? -delta : delta;
+  uint32_t window = edge_us - ws->last_edge;
+  if (delta != 0 && window > 0 &&
+      (magnitude % WHEEL_SPEED_CYCLE_COUNTS == 0 ||
+       magnitude >= WHEEL_SPEED_MAX_COUNTS ||
+       window >= WHEEL_SPEED_MAX_WINDOW_US))
+    Close_Window(ws, count, edge_us);
+
+  uint32_t idle = now_us - edge_us;
+  if (idle >= WHEEL_SPEED_STOP_US) {
+    memset(ws, 0, sizeof(*ws));
+    ws->last_count = count;
+    ws->stopped = true;
+    ws->initialized = true;
+    return ws->speed;
+  }
+
+  // 外推到采样时刻；起步后还没有完整窗口时先用不足整周期的计数估计
+  float speed = ws->window_speed +
+                ws->accel * (int32_t)(now_us - ws->window_mid) * 1e-6f;
+  if (!ws->has_window && delta != 0 && window > 0)
+    speed = delta * 1000000.0f / window;
+  float bound = WHEEL_SPEED_BOUND_COUNTS * 1000000.0f / (idle > 0 ? idle : 1);
+  if (speed > bound)
+    speed = bound;
+  else if (speed < -bound)
+    speed = -bound;
+  ws->speed = speed;
+  return speed;
+}
+
+// 速度换算为 cm/s
+float Wheel_Speed_Cm_S(const Wheel_Speed *ws) {
+  return ws->speed / ODOM_ENCODER_PER_CM;
+}
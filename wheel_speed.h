@@ -0,0 +1,40 @@
+#ifndef __WHEEL_SPEED_H
+#define __WHEEL_SPEED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 轮速测量（M/T法）：计数增量除以首末两个编码器边沿之间的时间，
+// 而不是除以采样周期，低速时不再只有0、1、2个计数的台阶
+// 窗口平均速度对应窗口中点，按相邻窗口估计的加速度外推到采样时刻
+// 纯算法模块，不依赖HAL，可直接在主机上编译
+// 每次采样由调用者传入：编码器累计值、产生该计数的最近一个边沿的时刻
+// （定时器输入捕获）和采样时刻，时间单位为微秒，允许32位回绕
+
+// 参数定义
+#define WHEEL_SPEED_CYCLE_COUNTS 4      // 正交周期的计数，窗口取整周期
+#define WHEEL_SPEED_MAX_COUNTS 32       // 计数达到该值时不再等整周期
+#define WHEEL_SPEED_MAX_WINDOW_US 50000 // 计数不足整周期时最长等待的时间
+#define WHEEL_SPEED_STOP_US 100000      // 超过该时间没有边沿视为停止
+#define WHEEL_SPEED_BOUND_COUNTS 1.5f   // 无边沿时的速度上限（含刻线误差余量）
+#define WHEEL_SPEED_ACCEL_ALPHA 0.5f    // 加速度估计的平滑系数
+
+typedef struct {
+  float speed;          // 采样时刻的速度 (计数/秒)，正负表示方向
+  float window_speed;   // 最近一个窗口的平均速度 (计数/秒)
+  float accel;          // 加速度 (计数/秒^2)
+  uint32_t window_mid;  // 最近一个窗口的中点时刻 (us)
+  int32_t last_count;   // 窗口起点的累计值
+  uint32_t last_edge;   // 窗口起点的边沿时刻 (us)
+  bool has_window;      // 起步后已经算出过窗口速度
+  bool stopped;         // 已判为停止，下一个边沿重新开始计时
+  bool initialized;
+} Wheel_Speed;
+
+// 函数声明
+void Wheel_Speed_Init(Wheel_Speed *ws);
+float Wheel_Speed_Update(Wheel_Speed *ws, int32_t count, uint32_t edge_us,
+                         uint32_t now_us);
+float Wheel_Speed_Cm_S(const Wheel_Speed *ws);
+
+#endif
@@ -1,4 +1,6 @@
 #include "bsp.h"
+#include "mode_manager.h"
+#include "motor_output.h"
 #include <stdlib.h>
 
 // 距离配置（单位：厘米）
@@ -15,60 +17,51 @@
 // M2==左后轮
 // M3==右前轮
 // M4==右后轮
-int16_t speed;
-int Encoder_M3 = 0;
-int Encoder_M2 = 0;
-int Encoder_M1 = 0;
-int Encoder_M4 = 0;
+static int16_t speed;
+static int Encoder_M3 = 0;
+static int Encoder_M2 = 0;
+static int Encoder_M1 = 0;
+static int Encoder_M4 = 0;
 
 // K2按键记录的编码器值
-int Encoder_M3_K2 = 0;
-int Encoder_M2_K2 = 0;
-int Encoder_M1_K2 = 0;
-int Encoder_M4_K2 = 0;
+static int Encoder_M3_K2 = 0;
+static int Encoder_M2_K2 = 0;
+static int Encoder_M1_K2 = 0;
+static int Encoder_M4_K2 = 0;
 
 // K3按键记录的编码器值
-int Encoder_M3_K3 = 0;
-int Encoder_M2_K3 = 0;
-int Encoder_M1_K3 = 0;
-int Encoder_M4_K3 = 0;
-
-// 电机控制函数
-void Set_All_Motors_Speed(int16_t speed) {
-  Motor_Set_Pwm(MOTOR_ID_M1, speed);
-  Motor_Set_Pwm(MOTOR_ID_M2, speed);
-  Motor_Set_Pwm(MOTOR_ID_M3, speed);
-  Motor_Set_Pwm(MOTOR_ID_M4, speed);
-}
-
-// 更新编码器值
-void Update_All_Encoders(void) {
-  Encoder_Update_Count();
-  Encoder_M1 = Encoder_Get_Count_Now(MOTOR_ID_M1);
-  Encoder_M2 = Encoder_Get_Count_Now(MOTOR_ID_M2);
-  Encoder_M3 = Encoder_Get_Count_Now(MOTOR_ID_M3);
-  Encoder_M4 = Encoder_Get_Count_Now(MOTOR_ID_M4);
+static int Encoder_M3_K3 = 0;
+static int Encoder_M2_K3 = 0;
+static int Encoder_M1_K3 = 0;
+static int Encoder_M4_K3 = 0;
+
+// 更新编码器值（由模式管理器在本周期采集）
+static void Update_All_Encoders(void) {
+  Encoder_M1 = sensor_data.encoder[MOTOR_ID_M1];
+  Encoder_M2 = sensor_data.encoder[MOTOR_ID_M2];
+  Encoder_M3 = sensor_data.encoder[MOTOR_ID_M3];
+  Encoder_M4 = sensor_data.encoder[MOTOR_ID_M4];
 }
 
 // 打印编码器值
-void Print_Encoders(const char *prefix) {
+static void Print_Encoders(const char *prefix) {
   printf("%s Encoder:%d,%d,%d,%d\r\n", prefix, Encoder_M1, Encoder_M2,
          Encoder_M3, Encoder_M4);
 }
 
 // 计算实际移动距离（厘米）
-float Calculate_Distance(int encoder_count) {
+static float Calculate_Distance(int encoder_count) {
   return (float)encoder_count / ENCODER_PER_CM;
 }
 
 // 计算误差百分比
-float Calculate_Error_Percentage(float actual_distance) {
+static float Calculate_Error_Percentage(float actual_distance) {
   return ((actual_distance - TARGET_DISTANCE_CM) / TARGET_DISTANCE_CM) * 100.0f;
 }
 
 // 打印调试信息
-void Print_Debug_Info(int encoder_diff, float actual_distance,
-                      float error_percentage) {
+static void Print_Debug_Info(int encoder_diff, float actual_distance,
+                             float error_percentage) {
   printf("\r\n=== Debug Report ===\r\n");
   printf("Target Distance: %.1f cm\r\n", TARGET_DISTANCE_CM);
   printf("Actual Distance: %.1f cm\r\n", actual_distance);
@@ -79,7 +72,8 @@ void Print_Debug_Info(int encoder_diff, float actual_distance,
 }
 
 // 检查编码器差值
-int Check_Encoder_Difference(int current, int recorded, int16_t motor_speed) {
+static int Check_Encoder_Difference(int current, int recorded,
+                                    int16_t motor_speed) {
   int target_diff =
       (motor_speed > 0) ? TARGET_ENCODER_COUNT : -TARGET_ENCODER_COUNT;
   int actual_diff = current - recorded;
@@ -90,7 +84,7 @@ int Check_Encoder_Difference(int current, int recorded, int16_t motor_speed) {
 }
 
 // 检查所有电机是否达到目标
-int Check_All_Motors_Target(int16_t motor_speed) {
+static int Check_All_Motors_Target(int16_t motor_speed) {
   if (motor_speed > 0) {
     return Check_Encoder_Difference(Encoder_M1, Encoder_M1_K2, motor_speed) &&
            Check_Encoder_Difference(Encoder_M2, Encoder_M2_K2, motor_speed) &&
@@ -105,9 +99,16 @@ int Check_All_Motors_Target(int16_t motor_speed) {
   return 0;
 }
 
-void BSP_Init(void) {
-  Bsp_UART1_Init();
-  Bsp_Tim_Init();
+static int Flag_K2 = 0;
+static int Flag_K3 = 0;
+static int movement_complete = 0;
+
+static void Straight_Init(void) {
+  Flag_K2 = 0;
+  Flag_K3 = 0;
+  movement_complete = 0;
+  speed = 0;
+  OLED_Draw_Line("Straight Mode", 0, true, true);
   printf("\r\n=== System Configuration ===\r\n");
   printf("Target Distance: %.1f cm\r\n", TARGET_DISTANCE_CM);
   printf("Target Encoder Count: %d\r\n", TARGET_ENCODER_COUNT);
@@ -115,13 +116,10 @@ void BSP_Init(void) {
   printf("========================\r\n\r\n");
 }
 
-void BSP_Loop(void) {
-  static int Flag_K2 = 0;
-  static int Flag_K3 = 0;
+static void Straight_Step(void) {
   static int Last_K2_State = 0;
   static int Last_K3_State = 0;
   static uint32_t last_print_time = 0;
-  static int movement_complete = 0;
 
   Update_All_Encoders();
 
@@ -134,7 +132,7 @@ void BSP_Loop(void) {
     Flag_K3 = 0;
     movement_complete = 0;
     speed = 0;
-    Set_All_Motors_Speed(speed);
+    Motor_Output_Set_LR(speed, speed);
     Print_Encoders("Manual mode active.");
   }
 
@@ -150,7 +148,7 @@ void BSP_Loop(void) {
     Encoder_M4_K2 = Encoder_M4;
 
     speed = 1000;
-    Set_All_Motors_Speed(speed);
+    Motor_Output_Set_LR(speed, speed);
     printf("\r\nStarting forward movement...\r\n");
     printf("Target: %.1f cm (%d encoder counts)\r\n", TARGET_DISTANCE_CM,
            TARGET_ENCODER_COUNT);
@@ -168,7 +166,7 @@ void BSP_Loop(void) {
     Encoder_M4_K3 = Encoder_M4;
 
     speed = -1000;
-    Set_All_Motors_Speed(speed);
+    Motor_Output_Set_LR(speed, speed);
     printf("\r\nStarting backward movement...\r\n");
     printf("Target: %.1f cm (%d encoder counts)\r\n", TARGET_DISTANCE_CM,
            TARGET_ENCODER_COUNT);
@@ -182,7 +180,7 @@ void BSP_Loop(void) {
     if (Check_All_Motors_Target(speed) && !movement_complete) {
       movement_complete = 1;
       speed = 0;
-      Set_All_Motors_Speed(speed);
+      Motor_Output_Set_LR(speed, speed);
 
       // 计算实际移动的距离和误差
       int encoder_diff;
@@ -221,3 +219,11 @@ void BSP_Loop(void) {
     last_print_time = current_time;
   }
 }
+
+static void Straight_Exit(void) {
+  speed = 0;
+  Motor_Output_Stop(1);
+}
+
+const Mode_Desc Mode_Straight = {"Straight", SENSOR_ENCODER, Straight_Init,
+                                 Straight_Step, Straight_Exit};
@@ -1,4 +1,6 @@
 #include "bsp.h"
+#include "mode_manager.h"
+#include "motor_output.h"
 #include <stdlib.h>
 // 配置参数
 #define TURN_ANGLE_DEG 90.0f
@@ -12,35 +14,30 @@
 #define PRINT_INTERVAL_MS 200 // 增加打印间隔，避免打印太频繁
 
 // 全局变量
-int16_t speed_left = 0;
-int16_t speed_right = 0;
-int Encoder_M1 = 0; // 左前轮
-int Encoder_M2 = 0; // 左后轮
-int Encoder_M3 = 0; // 右前轮
-int Encoder_M4 = 0; // 右后轮
+static int16_t speed_left = 0;
+static int16_t speed_right = 0;
+static int Encoder_M1 = 0; // 左前轮
+static int Encoder_M2 = 0; // 左后轮
+static int Encoder_M3 = 0; // 右前轮
+static int Encoder_M4 = 0; // 右后轮
 
 // 记录转弯开始时的编码器值
-int Encoder_M1_Start = 0;
-int Encoder_M2_Start = 0;
-int Encoder_M3_Start = 0;
-int Encoder_M4_Start = 0;
-
-void Update_All_Encoders(void) {
-  Encoder_Update_Count();
-  Encoder_M1 = Encoder_Get_Count_Now(MOTOR_ID_M1);
-  Encoder_M2 = Encoder_Get_Count_Now(MOTOR_ID_M2);
-  Encoder_M3 = Encoder_Get_Count_Now(MOTOR_ID_M3);
-  Encoder_M4 = Encoder_Get_Count_Now(MOTOR_ID_M4);
+static int Encoder_M1_Start = 0;
+static int Encoder_M2_Start = 0;
+static int Encoder_M3_Start = 0;
+static int Encoder_M4_Start = 0;
+
+static int turning_state = 0;
+
+// 更新编码器值（由模式管理器在本周期采集）
+static void Update_All_Encoders(void) {
+  Encoder_M1 = sensor_data.encoder[MOTOR_ID_M1];
+  Encoder_M2 = sensor_data.encoder[MOTOR_ID_M2];
+  Encoder_M3 = sensor_data.encoder[MOTOR_ID_M3];
+  Encoder_M4 = sensor_data.encoder[MOTOR_ID_M4];
 }
 
-void Set_Motors_Speed(int16_t left_speed, int16_t right_speed) {
-  Motor_Set_Pwm(MOTOR_ID_M1, left_speed);  // 左前
-  Motor_Set_Pwm(MOTOR_ID_M2, left_speed);  // 左后
-  Motor_Set_Pwm(MOTOR_ID_M3, right_speed); // 右前
-  Motor_Set_Pwm(MOTOR_ID_M4, right_speed); // 右后
-}
-
-int Check_Turn_Complete(void) {
+static int Check_Turn_Complete(void) {
   int left_diff = abs(Encoder_M1 - Encoder_M1_Start);
   int right_diff = abs(Encoder_M3 - Encoder_M3_Start);
   int avg_diff = (left_diff + right_diff) / 2;
@@ -48,16 +45,17 @@ int Check_Turn_Complete(void) {
   return (avg_diff >= TARGET_ENCODER_COUNT);
 }
 
-void BSP_Init(void) {
-  Bsp_UART1_Init();
-  Bsp_Tim_Init();
+static void Turn_Init(void) {
+  turning_state = 0;
+  speed_left = 0;
+  speed_right = 0;
+  OLED_Draw_Line("Turn Mode", 0, true, true);
   printf("\r\nTurn Control System Ready.\r\n");
   printf("Target Angle: %.1f degrees\r\n", TURN_ANGLE_DEG);
   printf("Target Encoder Count: %d\r\n", TARGET_ENCODER_COUNT);
 }
 
-void BSP_Loop(void) {
-  static int turning_state = 0;
+static void Turn_Step(void) {
   static uint32_t last_print_time = 0;
 
   Update_All_Encoders();
@@ -72,7 +70,7 @@ void BSP_Loop(void) {
 
     speed_left = TURN_SPEED;
     speed_right = -TURN_SPEED;
-    Set_Motors_Speed(speed_left, speed_right);
+    Motor_Output_Set_LR(speed_left, speed_right);
     printf("\r\nStarting right turn (Target: %d counts)...\r\n",
            TARGET_ENCODER_COUNT);
   }
@@ -87,7 +85,7 @@ void BSP_Loop(void) {
 
     speed_left = -TURN_SPEED;
     speed_right = TURN_SPEED;
-    Set_Motors_Speed(speed_left, speed_right);
+    Motor_Output_Set_LR(speed_left, speed_right);
     printf("\r\nStarting left turn (Target: %d counts)...\r\n",
            TARGET_ENCODER_COUNT);
   }
@@ -97,7 +95,7 @@ void BSP_Loop(void) {
     turning_state = 0;
     speed_left = 0;
     speed_right = 0;
-    Set_Motors_Speed(speed_left, speed_right);
+    Motor_Output_Set_LR(speed_left, speed_right);
 
     // 计算最终的编码器变化值
     int left_diff = abs(Encoder_M1 - Encoder_M1_Start);
@@ -115,7 +113,7 @@ void BSP_Loop(void) {
     turning_state = 0;
     speed_left = 0;
     speed_right = 0;
-    Set_Motors_Speed(speed_left, speed_right);
+    Motor_Output_Set_LR(speed_left, speed_right);
     printf("Emergency stop!\r\n");
   }
 
@@ -130,4 +128,14 @@ void BSP_Loop(void) {
            right_diff, TARGET_ENCODER_COUNT);
     last_print_time = current_time;
   }
-}
\ No newline at end of file
+}
+
+static void Turn_Exit(void) {
+  turning_state = 0;
+  speed_left = 0;
+  speed_right = 0;
+  Motor_Output_Stop(1);
+}
+
+const Mode_Desc Mode_Turn = {"Turn 90", SENSOR_ENCODER, Turn_Init, Turn_Step,
+                             Turn_Exit};
@@ -1,69 +1,84 @@
 #include "bsp.h"
+#include "kalman_filter.h"
+#include "mode_manager.h"
+#include "oled_status.h"
+#include "range_validator.h"
 
-// 卡尔曼滤波器结构体
-typedef struct {
-  float Q; // 过程噪声协方差
-  float R; // 测量噪声协方差
-  float P; // 估计误差协方差
-  float K; // 卡尔曼增益
-  float X; // 状态估计值
-} KalmanFilter;
+// 滤波参数
+#define RANGE_KF_Q 400.0f // 加速度过程噪声 ((cm/s^2)^2)
+#define RANGE_KF_R 0.1f   // 测量噪声方差 (cm^2)
 
-static KalmanFilter distance_filter;
-static char oled_buffer[32];
+// 显示刷新间隔（毫秒）
+#define DISPLAY_INTERVAL_MS 200
 
-// 初始化卡尔曼滤波器
-void Kalman_Init(KalmanFilter *filter) {
-  filter->Q = 0.1f;
-  filter->R = 0.1f;
-  filter->P = 1.0f;
-  filter->K = 0.0f;
-  filter->X = 0.0f;
-}
-
-// 卡尔曼滤波计算
-float Kalman_Update(KalmanFilter *filter, float measurement) {
-  // 预测
-  filter->P = filter->P + filter->Q;
+static Kalman_CV distance_filter;
+static Range_Validator range_validator;
+static Oled_Status display;
 
-  // 更新
-  filter->K = filter->P / (filter->P + filter->R);
-  filter->X = filter->X + filter->K * (measurement - filter->X);
-  filter->P = (1 - filter->K) * filter->P;
+static void Range_Init(void) {
+  // 初始化卡尔曼滤波器
+  Kalman_CV_Init(&distance_filter, RANGE_KF_Q, RANGE_KF_R);
+  Range_Validator_Init(&range_validator);
 
-  return filter->X;
+  OLED_Draw_Line("Distance Monitor", 1, true, true);
+  Oled_Status_Init(&display, 0);
 }
 
-void BSP_Init(void) {
-  Delay_Init();
-  Bsp_UART1_Init();
-  Bsp_TIM7_Init();
-  OLED_Init();
+static void Range_Step(void) {
+  static uint32_t last_display_time = 0;
+  static uint32_t last_sample_tick = 0;
+  static Range_Status status = RANGE_STATUS_TIMEOUT;
 
-  // 初始化卡尔曼滤波器
-  Kalman_Init(&distance_filter);
+  // 获取原始距离（由模式管理器采集，两次测距之间保持上一次的读数）
+  float raw_distance = sensor_data.distance;
 
-  OLED_Draw_Line("Distance Monitor", 1, true, true);
-}
+  // 有新测量时检验读数，有效时才应用卡尔曼滤波
+  if (sensor_data.distance_tick != last_sample_tick) {
+    last_sample_tick = sensor_data.distance_tick;
+    float valid_distance;
+    status = Range_Validator_Update(&range_validator, raw_distance,
+                                    sensor_data.distance_tick, &valid_distance);
+    if (status == RANGE_STATUS_OK) {
+      Kalman_CV_Update(&distance_filter, valid_distance,
+                       sensor_data.distance_tick);
+    }
+  }
 
-void BSP_Loop(void) {
-  // 获取原始距离
-  float raw_distance = Get_distance();
+  // 每次测量都参与滤波，显示和打印按固定间隔刷新
+  if (sensor_data.tick - last_display_time < DISPLAY_INTERVAL_MS)
+    return;
+  last_display_time = sensor_data.tick;
 
-  // 应用卡尔曼滤波
-  float filtered_distance = Kalman_Update(&distance_filter, raw_distance);
+  float filtered_distance = distance_filter.d;
+  float closing_speed = Kalman_CV_Closing_Speed(&distance_filter);
 
-  // 显示到OLED
-  snprintf(oled_buffer, sizeof(oled_buffer), "Raw: %.1f cm", raw_distance);
-  OLED_Draw_Line(oled_buffer, 2, false, false);
+  // 显示到OLED（数值不变的行不重画）
+  Oled_Text text;
+  Oled_Text_Clear(&text);
+  Oled_Text_Str(&text, "Raw: ");
+  Oled_Text_Fixed(&text, raw_distance, 1);
+  Oled_Text_Str(&text, " cm");
+  Oled_Status_Set(&display, 2, text.text);
 
-  snprintf(oled_buffer, sizeof(oled_buffer), "Filt: %.1f cm",
-           filtered_distance);
-  OLED_Draw_Line(oled_buffer, 3, false, true);
+  Oled_Text_Clear(&text);
+  Oled_Text_Str(&text, "Filt: ");
+  Oled_Text_Fixed(&text, filtered_distance, 1);
+  Oled_Text_Str(&text, " cm");
+  Oled_Status_Set(&display, 3, text.text);
+
+  Oled_Text_Clear(&text);
+  Oled_Text_Str(&text, "Vel: ");
+  Oled_Text_Fixed(&text, closing_speed, 1);
+  Oled_Text_Str(&text, " cm/s");
+  Oled_Status_Set(&display, 4, text.text);
+  Oled_Status_Flush(&display);
 
   // 打印到串口
-  printf("Distance - Raw: %.2f cm, Filtered: %.2f cm\r\n", raw_distance,
-         filtered_distance);
+  printf("Distance - Raw: %.2f cm, Filtered: %.2f cm, Closing: %.2f cm/s"
+         " [%s]\r\n",
+         raw_distance, filtered_distance, closing_speed,
+         Range_Status_Name(status));
+}
 
-  Delay_MS(200);
-}
\ No newline at end of file
+const Mode_Desc Mode_Range = {"Range", SENSOR_ULTRASONIC, Range_Init,
+                              Range_Step, NULL};
@@ -1,41 +1,49 @@
 #include "bsp.h"
+#include "follow_control.h"
+#include "fuzzy_control.h"
+#include "kalman_filter.h"
+#include "mode_manager.h"
+#include "motor_output.h"
+#include "obstacle_map.h"
+#include "odometry.h"
+#include "oled_status.h"
+#include "range_validator.h"
 #include <math.h>
 #include <stdlib.h>
 
 // 配置参数
 #define FOLLOW_STOP_DISTANCE 2.0f // 停止距离（厘米）
 #define FOLLOW_MAX_DISTANCE 10.0f // 最大跟随距离（厘米）
+#define FOLLOW_LOST_DISTANCE 20.0f // 跟随中拉开到该距离才视为丢失目标
 #define FOLLOW_BASE_DISTANCE 5.5f // 基准距离（5-6cm中间值）
 #define AVOID_DISTANCE 5.0f       // 避障距离（厘米）
 
 // 速度参数
 #define BASE_SPEED 800 // 基础速度
 #define MAX_SPEED 2000 // 最大速度
-#define SPEED_STEP 100 // 每厘米速度变化步长
 #define TURN_SPEED 800 // 转弯速度
 #define MIN_SPEED 300  // 最小速度，防止卡死
 
 // IR传感器阈值
 #define IR_TURN_THRESHOLD 200 // IR传感器转向阈值
-#define IR_BACK_THRESHOLD 100 // IR传感器后退阈值
 #define IR_MAX_VALUE 4095     // 12位ADC最大值
 
+// 测距滤波参数
+#define RANGE_KF_Q 2000.0f // 加速度过程噪声 ((cm/s^2)^2)
+#define RANGE_KF_R 0.1f    // 测量噪声方差 (cm^2)
+#define RANGE_KF_DT_MS 20  // 标称测距周期（用于稳态增益），也是本模式的测距间隔
+
+// 避障直方图转向参数
+#define AVOID_TURN_GAIN 200 // 每扇区偏移对应的转向量
+#define AVOID_MAX_TURN 800  // 最大转向量
+
 // 其他参数
 #define PRINT_INTERVAL_MS 100 // 打印间隔
 
-// 运行模式定义
-#define MODE_STOP 0
-#define MODE_FOLLOW 1
-#define MODE_AVOID 2
-
-// 卡尔曼滤波器结构体
-typedef struct {
-  float Q; // 过程噪声协方差
-  float R; // 测量噪声协方差
-  float P; // 估计误差协方差
-  float K; // 卡尔曼增益
-  float X; // 状态估计值
-} KalmanFilter;
+// 工作状态定义
+#define WORK_STOP 0
+#define WORK_FOLLOW 1
+#define WORK_AVOID 2
 
 // 模糊控制结构体
 typedef struct {
@@ -47,84 +55,69 @@ typedef struct {
 } FuzzyControl;
 
 // 全局变量
-static KalmanFilter distance_filter;
+static Kalman_CV_Fixed distance_filter;
+static Kalman_CV_Fixed leader_filter; // 前车沿行驶方向的位置（里程+间距）
+static Range_Validator range_validator;
+static Odometry odometry;
+static Obstacle_Map obstacle_map;
+static Follow_Control follow_control;
+static float vehicle_speed = 0.0f; // 本车速度 (cm/s)
+static float travel = 0.0f;        // 本车累计前进距离 (cm)
+// 最近几次测距时的累计距离：滑动中值的输出约滞后半个窗口，
+// 前车位置取与之同一时刻的累计距离，否则本车加减速会被当成前车速度变化
+static float travel_log[RANGE_MEDIAN_SIZE / 2 + 1];
+static uint8_t travel_index = 0;
+static uint32_t last_range_tick = 0; // 上一次处理的测距时刻
+static uint32_t control_dt_ms = 0; // 本次控制周期
+static uint32_t last_loop_time = 0;
+static bool follow_locked = false; // 已在跟随距离内锁定目标
 static FuzzyControl fuzzy_control;
-static char oled_buffer[32];
+static Oled_Status display; // 第1行为标题
 static int16_t speed_left = 0;
 static int16_t speed_right = 0;
-static int working_mode = MODE_STOP;
-
-// 卡尔曼滤波器初始化
-void Kalman_Init(KalmanFilter *filter) {
-  filter->Q = 0.1f;
-  filter->R = 0.1f;
-  filter->P = 1.0f;
-  filter->K = 0.0f;
-  filter->X = 0.0f;
-}
-
-// 卡尔曼滤波器更新
-float Kalman_Update(KalmanFilter *filter, float measurement) {
-  filter->P = filter->P + filter->Q;
-  filter->K = filter->P / (filter->P + filter->R);
-  filter->X = filter->X + filter->K * (measurement - filter->X);
-  filter->P = (1 - filter->K) * filter->P;
-  return filter->X;
-}
-
-// 计算跟随速度的辅助函数（仅处理2-10cm范围）
-int16_t Calculate_Follow_Speed(float current_distance) {
-  int16_t target_speed;
-
-  if (current_distance > 6.0f) {
-    // 6-10cm 加速追赶
-    float over_distance = current_distance - 6.0f;
-    int16_t extra_speed = (int16_t)(over_distance * SPEED_STEP);
-    target_speed = BASE_SPEED + extra_speed;
-    // 限制最大速度
-    return (target_speed > MAX_SPEED) ? MAX_SPEED : target_speed;
-  } else if (current_distance >= 5.0f) {
-    // 5-6cm 使用基础速度
-    return BASE_SPEED;
-  } else {
-    // 2-5cm 递减速度
-    float slow_distance = 5.0f - current_distance;
-    target_speed = BASE_SPEED - (int16_t)(slow_distance * SPEED_STEP);
-    // 限制最小速度
-    return (target_speed < MIN_SPEED) ? MIN_SPEED : target_speed;
-  }
-}
-
-void Fuzzy_Control_Update(FuzzyControl *ctrl, float current_distance,
-                          bool is_follow_mode) {
-  // 获取IR传感器数据
-  uint16_t left_ir, right_ir;
-  Get_Iravoid_Data(&left_ir, &right_ir);
+static int working_mode = WORK_STOP;
+
+Follow_Avoid_Config follow_avoid_config = {
+    FOLLOW_STOP_DISTANCE, FOLLOW_MAX_DISTANCE, FOLLOW_LOST_DISTANCE,
+    FOLLOW_BASE_DISTANCE, BASE_SPEED, MAX_SPEED, TURN_SPEED, MIN_SPEED,
+    IR_TURN_THRESHOLD, AVOID_TURN_GAIN, AVOID_MAX_TURN};
+
+static void Fuzzy_Control_Update(FuzzyControl *ctrl, float current_distance,
+                                 bool is_follow_mode) {
+  // 获取IR传感器数据（由模式管理器在本周期采集）
+  uint16_t left_ir = sensor_data.ir_left;
+  uint16_t right_ir = sensor_data.ir_right;
+  const Follow_Avoid_Config *cfg = &follow_avoid_config;
   ctrl->ir_left_value = left_ir;
   ctrl->ir_right_value = right_ir;
 
   if (is_follow_mode) {
     // 跟随模式
-    if (current_distance <= FOLLOW_STOP_DISTANCE) {
+    if (current_distance <= cfg->stop_distance) {
       // 0-2cm，停止
+      follow_locked = false;
+      Follow_Control_Reset(&follow_control, 0);
       ctrl->left_speed = 0;
       ctrl->right_speed = 0;
       return;
     }
 
-    if (current_distance > FOLLOW_MAX_DISTANCE) {
-      // 距离超过10cm，寻找目标
-      bool left_detected = (left_ir < IR_TURN_THRESHOLD);
-      bool right_detected = (right_ir < IR_TURN_THRESHOLD);
+    // 已锁定的目标拉开到丢失距离、未锁定时超过10cm，寻找目标
+    if (current_distance >
+        (follow_locked ? cfg->lost_distance : cfg->max_distance)) {
+      follow_locked = false;
+      Follow_Control_Reset(&follow_control, 0);
+      bool left_detected = (left_ir < cfg->ir_threshold);
+      bool right_detected = (right_ir < cfg->ir_threshold);
 
       if (left_detected && !right_detected) {
         // 仅左侧检测到目标，原地左转
-        ctrl->left_speed = -TURN_SPEED;
-        ctrl->right_speed = TURN_SPEED;
+        ctrl->left_speed = -cfg->turn_speed;
+        ctrl->right_speed = cfg->turn_speed;
       } else if (!left_detected && right_detected) {
         // 仅右侧检测到目标，原地右转
-        ctrl->left_speed = TURN_SPEED;
-        ctrl->right_speed = -TURN_SPEED;
+        ctrl->left_speed = cfg->turn_speed;
+        ctrl->right_speed = -cfg->turn_speed;
       } else {
         // 两侧都检测到或都未检测到，停止
         ctrl->left_speed = 0;
@@ -133,118 +126,186 @@ void Fuzzy_Control_Update(FuzzyControl *ctrl, float current_distance,
       return;
     }
 
-    // 2-10cm范围内，计算跟随速度
-    int16_t follow_speed = Calculate_Follow_Speed(current_distance);
+    // 跟随范围内：间距反馈 + 前车速度前馈，输出经变化率限制
+    // 前车速度取前车绝对位置的滤波速度，不含本车速度，
+    // 本车实际速度与命令不符时由接近速度反映出来
+    follow_locked = true;
+    follow_control.target_gap = cfg->base_distance;
+    follow_control.max_output = cfg->max_speed;
+    float leader_speed = -Kalman_CV_Fixed_Closing_Speed(&leader_filter);
+    int16_t follow_speed = Follow_Control_Update(
+        &follow_control, current_distance, vehicle_speed - leader_speed,
+        vehicle_speed, control_dt_ms);
     ctrl->left_speed = follow_speed;
     ctrl->right_speed = follow_speed;
     return;
   } else {
-    // 避障模式
-    if (current_distance < AVOID_DISTANCE) {
-      // 距离小于5cm，后退
-      ctrl->left_speed = -BASE_SPEED;
-      ctrl->right_speed = -BASE_SPEED;
+    // 避障模式：先更新障碍直方图，再由模糊控制曲面给出近距离反射动作
+    Obstacle_Map_Update(&obstacle_map, odometry.heading, current_distance,
+                        left_ir, right_ir);
+    Fuzzy_Avoid_Lookup(current_distance, left_ir, right_ir, &ctrl->left_speed,
+                       &ctrl->right_speed);
+
+    // 反射动作为后退/原地转向或所有方向被堵时，直接执行反射动作
+    Obstacle_Steer steer = Obstacle_Map_Select(&obstacle_map, odometry.heading);
+    if (steer.blocked ||
+        ctrl->left_speed + ctrl->right_speed < FUZZY_SLOW_SPEED) {
       return;
     }
 
-    // IR避障控制
-    if (left_ir < IR_BACK_THRESHOLD || right_ir < IR_BACK_THRESHOLD) {
-      // 非常接近障碍物，后退
-      ctrl->left_speed = -BASE_SPEED;
-      ctrl->right_speed = -BASE_SPEED;
-    } else if (left_ir < IR_TURN_THRESHOLD && right_ir < IR_TURN_THRESHOLD) {
-      // 两侧都较近，后退
-      ctrl->left_speed = -BASE_SPEED;
-      ctrl->right_speed = -BASE_SPEED;
-    } else if (left_ir < IR_TURN_THRESHOLD) {
-      // 左侧障碍物，向右转
-      ctrl->left_speed = BASE_SPEED;
-      ctrl->right_speed = -BASE_SPEED;
-    } else if (right_ir < IR_TURN_THRESHOLD) {
-      // 右侧障碍物，向左转
-      ctrl->left_speed = -BASE_SPEED;
-      ctrl->right_speed = BASE_SPEED;
-    } else {
-      // 无障碍，前进
-      ctrl->left_speed = BASE_SPEED;
-      ctrl->right_speed = BASE_SPEED;
-    }
+    // 否则沿直方图选出的空闲方向保持前进，越空旷速度越高
+    int32_t slowdown = (int32_t)(cfg->base_speed - cfg->min_speed) *
+                       steer.density / OBST_BLOCK_LEVEL;
+    int16_t speed = cfg->base_speed - slowdown;
+    int16_t turn = steer.offset * cfg->avoid_turn_gain;
+    if (turn > cfg->avoid_max_turn)
+      turn = cfg->avoid_max_turn;
+    if (turn < -cfg->avoid_max_turn)
+      turn = -cfg->avoid_max_turn;
+    ctrl->left_speed = speed - turn;
+    ctrl->right_speed = speed + turn;
   }
 }
 
-// 设置电机速度
-void Set_Motors_Speed(int16_t left_speed, int16_t right_speed) {
-  Motor_Set_Pwm(MOTOR_ID_M1, left_speed);  // 左前
-  Motor_Set_Pwm(MOTOR_ID_M2, left_speed);  // 左后
-  Motor_Set_Pwm(MOTOR_ID_M3, right_speed); // 右前
-  Motor_Set_Pwm(MOTOR_ID_M4, right_speed); // 右后
+// 读取左右两侧编码器累计值（各取前后轮平均）
+static void Read_Wheel_Counts(int32_t *left, int32_t *right) {
+  *left = (sensor_data.encoder[MOTOR_ID_M1] + sensor_data.encoder[MOTOR_ID_M2]) /
+          2;
+  *right =
+      (sensor_data.encoder[MOTOR_ID_M3] + sensor_data.encoder[MOTOR_ID_M4]) / 2;
 }
 
 // 更新OLED显示
-void Update_Display(float raw_distance, float filtered_distance,
-                    uint16_t left_ir, uint16_t right_ir) {
+static void Update_Display(float raw_distance, float filtered_distance,
+                           uint16_t left_ir, uint16_t right_ir) {
   const char *mode_str = "Stop";
-  if (working_mode == MODE_FOLLOW)
+  if (working_mode == WORK_FOLLOW)
     mode_str = "Follow";
-  if (working_mode == MODE_AVOID)
+  if (working_mode == WORK_AVOID)
     mode_str = "Avoid";
 
-  OLED_Draw_Line("Distance Monitor", 1, true, false);
-  snprintf(oled_buffer, sizeof(oled_buffer), "Mode:%s D:%.1f", mode_str,
-           filtered_distance);
-  OLED_Draw_Line(oled_buffer, 2, false, false);
-  snprintf(oled_buffer, sizeof(oled_buffer), "IR L:%d R:%d", left_ir, right_ir);
-  OLED_Draw_Line(oled_buffer, 3, false, true);
-}
+  Oled_Text text;
+  Oled_Status_Set(&display, 1, "Distance Monitor");
+
+  Oled_Text_Clear(&text);
+  Oled_Text_Str(&text, "Mode:");
+  Oled_Text_Str(&text, mode_str);
+  Oled_Text_Str(&text, " D:");
+  Oled_Text_Fixed(&text, filtered_distance, 1);
+  Oled_Status_Set(&display, 2, text.text);
+
+  Oled_Text_Clear(&text);
+  Oled_Text_Str(&text, "IR L:");
+  Oled_Text_Int(&text, left_ir);
+  Oled_Text_Str(&text, " R:");
+  Oled_Text_Int(&text, right_ir);
+  Oled_Status_Set(&display, 3, text.text);
 
-// 系统初始化
-void BSP_Init(void) {
-  Delay_Init();
-  Bsp_Tim_Init();
-  Bsp_UART1_Init();
-  Bsp_TIM7_Init();
-  OLED_Init();
+  Oled_Status_Flush(&display); // 只重画变化的行
+}
 
-  Kalman_Init(&distance_filter);
+// 模式初始化
+static void Follow_Avoid_Init(void) {
+  working_mode = WORK_STOP;
+  speed_left = speed_right = 0;
+
+  Kalman_CV_Fixed_Init(&distance_filter, RANGE_KF_Q, RANGE_KF_R,
+                       RANGE_KF_DT_MS);
+  Kalman_CV_Fixed_Init(&leader_filter, RANGE_KF_Q, RANGE_KF_R, RANGE_KF_DT_MS);
+  Range_Validator_Init(&range_validator);
+  Follow_Control_Init(&follow_control, follow_avoid_config.base_distance, 0,
+                      follow_avoid_config.max_speed);
+  Obstacle_Map_Init(&obstacle_map);
+  int32_t left_count, right_count;
+  Read_Wheel_Counts(&left_count, &right_count);
+  Odometry_Init(&odometry, left_count, right_count);
+  travel = 0.0f;
+  memset(travel_log, 0, sizeof(travel_log));
+  travel_index = 0;
+  last_range_tick = sensor_data.distance_tick; // 进入模式前的读数不再处理
+  follow_locked = false;
+
+  // 从进入模式时开始计时，首个周期的变化率限制不会按开机以来的时间放开
+  last_loop_time = HAL_GetTick();
 
   printf("\r\nEnhanced Control System Ready\r\n");
-  printf("Key2: Follow Mode (%.1f-%.1f cm)\r\n", FOLLOW_STOP_DISTANCE,
-         FOLLOW_MAX_DISTANCE);
+  printf("Key2: Follow Mode (%.1f-%.1f cm)\r\n",
+         follow_avoid_config.stop_distance, follow_avoid_config.max_distance);
   printf("Key3: Avoid Mode (%.1f cm)\r\n", AVOID_DISTANCE);
   printf("Key1: Stop\r\n");
 
   OLED_Draw_Line("System Ready", 1, true, true);
+  Oled_Status_Init(&display, 1 << 1);
 }
 
-// 主循环
-void BSP_Loop(void) {
+// 模式单步
+static void Follow_Avoid_Step(void) {
   static uint32_t last_print_time = 0;
-
-  // 获取距离并应用卡尔曼滤波
-  float raw_distance = Get_distance();
-  float filtered_distance = Kalman_Update(&distance_filter, raw_distance);
+  static float filtered_distance = RANGE_MAX_VALID_CM;
+
+  uint32_t loop_time = sensor_data.tick;
+  control_dt_ms = loop_time - last_loop_time;
+  last_loop_time = loop_time;
+
+  // 更新里程计航向（避障直方图使用）、本车速度和累计距离（跟随使用）
+  int32_t left_count, right_count;
+  Read_Wheel_Counts(&left_count, &right_count);
+  Odometry_Update(&odometry, left_count, right_count);
+  travel += odometry.speed;
+  if (control_dt_ms > 0)
+    vehicle_speed = odometry.speed * 1000.0f / control_dt_ms;
+
+  // 获取距离（由模式管理器采集，两次测距之间保持上一次的读数），
+  // 有新测量时检验，通过后才送入卡尔曼滤波
+  float raw_distance = sensor_data.distance;
+  uint32_t range_tick = sensor_data.distance_tick;
+  if (range_tick != last_range_tick) {
+    last_range_tick = range_tick;
+    travel_log[travel_index] = travel;
+    travel_index = (travel_index + 1) % (RANGE_MEDIAN_SIZE / 2 + 1);
+
+    float valid_distance;
+    switch (Range_Validator_Update(&range_validator, raw_distance, range_tick,
+                                   &valid_distance)) {
+    case RANGE_STATUS_OK:
+      filtered_distance =
+          Kalman_CV_Fixed_Update(&distance_filter, valid_distance, range_tick);
+      Kalman_CV_Fixed_Update(&leader_filter,
+                             travel_log[travel_index] + valid_distance,
+                             range_tick);
+      break;
+    case RANGE_STATUS_NO_ECHO:
+      filtered_distance = RANGE_MAX_VALID_CM; // 前方无障碍
+      break;
+    default: // 超时或异常值：保持上一次的滤波结果
+      break;
+    }
+  }
 
   // 按键处理
   if (Key1_State(0)) {
-    working_mode = MODE_STOP;
+    working_mode = WORK_STOP;
     speed_left = speed_right = 0;
   }
-  if (Key2_State(0))
-    working_mode = MODE_FOLLOW;
+  if (Key2_State(0) && working_mode != WORK_FOLLOW) {
+    working_mode = WORK_FOLLOW;
+    follow_locked = false;
+    Follow_Control_Reset(&follow_control, (speed_left + speed_right) / 2);
+  }
   if (Key3_State(0))
-    working_mode = MODE_AVOID;
+    working_mode = WORK_AVOID;
 
   // 根据模式执行控制
   switch (working_mode) {
-  case MODE_FOLLOW:
+  case WORK_FOLLOW:
     Fuzzy_Control_Update(&fuzzy_control, filtered_distance, true);
     break;
 
-  case MODE_AVOID:
+  case WORK_AVOID:
     Fuzzy_Control_Update(&fuzzy_control, filtered_distance, false);
     break;
 
-  default: // MODE_STOP
+  default: // WORK_STOP
     fuzzy_control.left_speed = 0;
     fuzzy_control.right_speed = 0;
     break;
@@ -253,18 +314,35 @@ void BSP_Loop(void) {
   // 更新电机速度
   speed_left = fuzzy_control.left_speed;
   speed_right = fuzzy_control.right_speed;
-  Set_Motors_Speed(speed_left, speed_right);
+  Motor_Output_Set_LR(speed_left, speed_right);
 
   // 更新显示
   Update_Display(raw_distance, filtered_distance, fuzzy_control.ir_left_value,
                  fuzzy_control.ir_right_value);
 
   // 定期打印状态
-  uint32_t current_time = HAL_GetTick();
+  uint32_t current_time = sensor_data.tick;
   if (current_time - last_print_time >= PRINT_INTERVAL_MS) {
     printf("Mode:%d Dist:%.1f IR(L/R):%.0f/%.0f Speed(L/R):%d/%d\r\n",
            working_mode, filtered_distance, fuzzy_control.ir_left_value,
            fuzzy_control.ir_right_value, speed_left, speed_right);
+    printf("Range:%s ok/out/to/ne:%lu/%lu/%lu/%lu\r\n",
+           Range_Status_Name(range_validator.status),
+           (unsigned long)range_validator.counters.ok,
+           (unsigned long)range_validator.counters.outlier,
+           (unsigned long)range_validator.counters.timeout,
+           (unsigned long)range_validator.counters.no_echo);
     last_print_time = current_time;
   }
-}
\ No newline at end of file
+}
+
+// 退出模式：停车
+static void Follow_Avoid_Exit(void) {
+  working_mode = WORK_STOP;
+  speed_left = speed_right = 0;
+  Motor_Output_Stop(1);
+}
+
+const Mode_Desc Mode_Follow_Avoid = {
+    "Follow/Avoid", SENSOR_ULTRASONIC | SENSOR_IR | SENSOR_ENCODER,
+    Follow_Avoid_Init, Follow_Avoid_Step, Follow_Avoid_Exit, 0, RANGE_KF_DT_MS};